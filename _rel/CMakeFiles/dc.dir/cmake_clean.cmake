@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/dc.dir/main.cpp.o"
+  "CMakeFiles/dc.dir/main.cpp.o.d"
+  "dc"
+  "dc.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/dc.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
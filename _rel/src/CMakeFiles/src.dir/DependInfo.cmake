@@ -0,0 +1,44 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/adt.cpp" "src/CMakeFiles/src.dir/adt.cpp.o" "gcc" "src/CMakeFiles/src.dir/adt.cpp.o.d"
+  "/root/repo/src/arena.cpp" "src/CMakeFiles/src.dir/arena.cpp.o" "gcc" "src/CMakeFiles/src.dir/arena.cpp.o.d"
+  "/root/repo/src/batch.cpp" "src/CMakeFiles/src.dir/batch.cpp.o" "gcc" "src/CMakeFiles/src.dir/batch.cpp.o.d"
+  "/root/repo/src/bitwise.cpp" "src/CMakeFiles/src.dir/bitwise.cpp.o" "gcc" "src/CMakeFiles/src.dir/bitwise.cpp.o.d"
+  "/root/repo/src/client.cpp" "src/CMakeFiles/src.dir/client.cpp.o" "gcc" "src/CMakeFiles/src.dir/client.cpp.o.d"
+  "/root/repo/src/compiler.cpp" "src/CMakeFiles/src.dir/compiler.cpp.o" "gcc" "src/CMakeFiles/src.dir/compiler.cpp.o.d"
+  "/root/repo/src/environment.cpp" "src/CMakeFiles/src.dir/environment.cpp.o" "gcc" "src/CMakeFiles/src.dir/environment.cpp.o.d"
+  "/root/repo/src/error.cpp" "src/CMakeFiles/src.dir/error.cpp.o" "gcc" "src/CMakeFiles/src.dir/error.cpp.o.d"
+  "/root/repo/src/eval.cpp" "src/CMakeFiles/src.dir/eval.cpp.o" "gcc" "src/CMakeFiles/src.dir/eval.cpp.o.d"
+  "/root/repo/src/jit.cpp" "src/CMakeFiles/src.dir/jit.cpp.o" "gcc" "src/CMakeFiles/src.dir/jit.cpp.o.d"
+  "/root/repo/src/lexer.cpp" "src/CMakeFiles/src.dir/lexer.cpp.o" "gcc" "src/CMakeFiles/src.dir/lexer.cpp.o.d"
+  "/root/repo/src/macro.cpp" "src/CMakeFiles/src.dir/macro.cpp.o" "gcc" "src/CMakeFiles/src.dir/macro.cpp.o.d"
+  "/root/repo/src/macro_cache.cpp" "src/CMakeFiles/src.dir/macro_cache.cpp.o" "gcc" "src/CMakeFiles/src.dir/macro_cache.cpp.o.d"
+  "/root/repo/src/mathematics.cpp" "src/CMakeFiles/src.dir/mathematics.cpp.o" "gcc" "src/CMakeFiles/src.dir/mathematics.cpp.o.d"
+  "/root/repo/src/num_utils.cpp" "src/CMakeFiles/src.dir/num_utils.cpp.o" "gcc" "src/CMakeFiles/src.dir/num_utils.cpp.o.d"
+  "/root/repo/src/output.cpp" "src/CMakeFiles/src.dir/output.cpp.o" "gcc" "src/CMakeFiles/src.dir/output.cpp.o.d"
+  "/root/repo/src/pipeline.cpp" "src/CMakeFiles/src.dir/pipeline.cpp.o" "gcc" "src/CMakeFiles/src.dir/pipeline.cpp.o.d"
+  "/root/repo/src/register_array.cpp" "src/CMakeFiles/src.dir/register_array.cpp.o" "gcc" "src/CMakeFiles/src.dir/register_array.cpp.o.d"
+  "/root/repo/src/register_file.cpp" "src/CMakeFiles/src.dir/register_file.cpp.o" "gcc" "src/CMakeFiles/src.dir/register_file.cpp.o.d"
+  "/root/repo/src/script.cpp" "src/CMakeFiles/src.dir/script.cpp.o" "gcc" "src/CMakeFiles/src.dir/script.cpp.o.d"
+  "/root/repo/src/server.cpp" "src/CMakeFiles/src.dir/server.cpp.o" "gcc" "src/CMakeFiles/src.dir/server.cpp.o.d"
+  "/root/repo/src/shared_string.cpp" "src/CMakeFiles/src.dir/shared_string.cpp.o" "gcc" "src/CMakeFiles/src.dir/shared_string.cpp.o.d"
+  "/root/repo/src/stack.cpp" "src/CMakeFiles/src.dir/stack.cpp.o" "gcc" "src/CMakeFiles/src.dir/stack.cpp.o.d"
+  "/root/repo/src/statistics.cpp" "src/CMakeFiles/src.dir/statistics.cpp.o" "gcc" "src/CMakeFiles/src.dir/statistics.cpp.o.d"
+  "/root/repo/src/thread_pool.cpp" "src/CMakeFiles/src.dir/thread_pool.cpp.o" "gcc" "src/CMakeFiles/src.dir/thread_pool.cpp.o.d"
+  "/root/repo/src/value.cpp" "src/CMakeFiles/src.dir/value.cpp.o" "gcc" "src/CMakeFiles/src.dir/value.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
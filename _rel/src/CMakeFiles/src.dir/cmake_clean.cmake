@@ -0,0 +1,61 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/src.dir/adt.cpp.o"
+  "CMakeFiles/src.dir/adt.cpp.o.d"
+  "CMakeFiles/src.dir/arena.cpp.o"
+  "CMakeFiles/src.dir/arena.cpp.o.d"
+  "CMakeFiles/src.dir/batch.cpp.o"
+  "CMakeFiles/src.dir/batch.cpp.o.d"
+  "CMakeFiles/src.dir/bitwise.cpp.o"
+  "CMakeFiles/src.dir/bitwise.cpp.o.d"
+  "CMakeFiles/src.dir/client.cpp.o"
+  "CMakeFiles/src.dir/client.cpp.o.d"
+  "CMakeFiles/src.dir/compiler.cpp.o"
+  "CMakeFiles/src.dir/compiler.cpp.o.d"
+  "CMakeFiles/src.dir/environment.cpp.o"
+  "CMakeFiles/src.dir/environment.cpp.o.d"
+  "CMakeFiles/src.dir/error.cpp.o"
+  "CMakeFiles/src.dir/error.cpp.o.d"
+  "CMakeFiles/src.dir/eval.cpp.o"
+  "CMakeFiles/src.dir/eval.cpp.o.d"
+  "CMakeFiles/src.dir/jit.cpp.o"
+  "CMakeFiles/src.dir/jit.cpp.o.d"
+  "CMakeFiles/src.dir/lexer.cpp.o"
+  "CMakeFiles/src.dir/lexer.cpp.o.d"
+  "CMakeFiles/src.dir/macro.cpp.o"
+  "CMakeFiles/src.dir/macro.cpp.o.d"
+  "CMakeFiles/src.dir/macro_cache.cpp.o"
+  "CMakeFiles/src.dir/macro_cache.cpp.o.d"
+  "CMakeFiles/src.dir/mathematics.cpp.o"
+  "CMakeFiles/src.dir/mathematics.cpp.o.d"
+  "CMakeFiles/src.dir/num_utils.cpp.o"
+  "CMakeFiles/src.dir/num_utils.cpp.o.d"
+  "CMakeFiles/src.dir/output.cpp.o"
+  "CMakeFiles/src.dir/output.cpp.o.d"
+  "CMakeFiles/src.dir/pipeline.cpp.o"
+  "CMakeFiles/src.dir/pipeline.cpp.o.d"
+  "CMakeFiles/src.dir/register_array.cpp.o"
+  "CMakeFiles/src.dir/register_array.cpp.o.d"
+  "CMakeFiles/src.dir/register_file.cpp.o"
+  "CMakeFiles/src.dir/register_file.cpp.o.d"
+  "CMakeFiles/src.dir/script.cpp.o"
+  "CMakeFiles/src.dir/script.cpp.o.d"
+  "CMakeFiles/src.dir/server.cpp.o"
+  "CMakeFiles/src.dir/server.cpp.o.d"
+  "CMakeFiles/src.dir/shared_string.cpp.o"
+  "CMakeFiles/src.dir/shared_string.cpp.o.d"
+  "CMakeFiles/src.dir/stack.cpp.o"
+  "CMakeFiles/src.dir/stack.cpp.o.d"
+  "CMakeFiles/src.dir/statistics.cpp.o"
+  "CMakeFiles/src.dir/statistics.cpp.o.d"
+  "CMakeFiles/src.dir/thread_pool.cpp.o"
+  "CMakeFiles/src.dir/thread_pool.cpp.o.d"
+  "CMakeFiles/src.dir/value.cpp.o"
+  "CMakeFiles/src.dir/value.cpp.o.d"
+  "libsrc.a"
+  "libsrc.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/src.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -1,13 +1,22 @@
 #include <iostream>
+#include <functional>
+#include <thread>
+#include <optional>
+#include <charconv>
+#include <unistd.h>
 #include <getopt.h>
-#include <vector>
-#include <sstream>
-#include <iterator>
-#include <fstream>
 
 #include "src/adt.h"
 #include "src/eval.h"
-#include "src/macro.h" // for split static method
+#include "src/macro_cache.h"
+#include "src/arena.h"
+#include "src/jit.h"
+#include "src/script.h"
+#include "src/output.h"
+#include "src/pipeline.h"
+#include "src/batch.h"
+#include "src/server.h"
+#include "src/client.h"
 
 using namespace dc;
 
@@ -19,6 +28,22 @@ void helper() {
     std::cout << "RPN desktop calculator and stack-based programming language. Usage:\n"
               << "-e, --expression <EXPRESSION> | Evaluate an expression\n"
               << "-f, --file <FILE>             | Evaluate a file\n"
+              << "--cache-stats                 | Print macro cache statistics on exit\n"
+              << "--arena-stats                 | Print allocation statistics on exit\n"
+              << "--no-arena                    | Allocate the temporaries of each line on the heap\n"
+              << "--no-peephole                 | Disable superinstructions\n"
+              << "--switch-dispatch             | Dispatch instructions with a switch\n"
+              << "--jit                         | Compile numeric macros into native code\n"
+              << "--line-buffered               | Flush the output at the end of each line\n"
+              << "--pipeline                    | Read, evaluate and write stdin on separate threads\n"
+              << "--batch                       | Evaluate each line of stdin independently, in parallel\n"
+              << "--jobs <N>                    | Number of threads of the batch mode\n"
+              << "--batch-stats                 | Print batch throughput on exit\n"
+              << "--server <SOCKET>             | Serve sessions on a Unix domain socket\n"
+              << "--library <FILE>              | Load the macros of a file into every session\n"
+              << "--connect <SOCKET>            | Evaluate stdin or an expression on a server\n"
+              << "--load-test <N>               | Send N requests to a server and print the latency\n"
+              << "--connections <N>             | Number of connections of the load test\n"
               << "-h, --help                    | Show this helper\n"
               << "-V, --version                 | Show version" << std::endl;
 }
@@ -40,6 +65,115 @@ void version() {
               << "Email bug reports to: <email@marcocetica.com>." << std::endl;
 }
 
+/**
+ * @brief Prints the hit/miss counters of the macro cache
+ */
+
+void cache_stats() {
+    auto stats = MacroCache::instance().stats();
+    Output::instance().error("Macro cache: " + std::to_string(stats.hits) + " hits, " +
+                             std::to_string(stats.misses) + " misses, " + std::to_string(stats.evictions) +
+                             " evictions, " + std::to_string(stats.size) + " entries");
+}
+
+/**
+ * @brief Prints the counters of the arena of the evaluation
+ */
+
+static const Arena *stats_arena = nullptr;
+
+void arena_stats() {
+    auto stats = stats_arena->stats();
+    auto lines = std::max<std::size_t>(stats.lines, 1);
+    Output::instance().error("Arena: " + std::to_string(stats.lines) + " lines, " +
+                             std::to_string(stats.allocations) + " allocations, " +
+                             std::to_string(stats.upstream_allocations) + " upstream allocations, " +
+                             std::to_string(stats.high_water_mark) + " bytes high-water mark");
+    // Heap allocations are only counted when dc is built with DC_COUNT_ALLOCATIONS
+    if(stats.heap_allocations) {
+        Output::instance().error("Heap: " + std::to_string(*stats.heap_allocations) + " allocations, " +
+                                 std::to_string(*stats.heap_allocations / lines) + " per line");
+    }
+}
+
+/**
+ * @brief Parses a positive count given on the command line
+ * @param str The argument
+ * @param max The largest count accepted
+ * @return The count, std::nullopt if the argument is not a number between 1 and **max**
+ */
+
+std::optional<std::size_t> parse_count(std::string_view str, std::size_t max) {
+    std::size_t count = 0;
+    // Unsigned conversions reject the minus sign
+    auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), count);
+    if(ec != std::errc() || end != str.data() + str.size() || count < 1 || count > max) {
+        return std::nullopt;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Prints the throughput of the batch mode
+ */
+
+void batch_stats(const BatchStats &stats) {
+    auto rate = (stats.seconds > 0) ? static_cast<double>(stats.lines) / stats.seconds : 0.0;
+    Output::instance().error("Batch: " + std::to_string(stats.lines) + " lines, " +
+                             std::to_string(stats.seconds) + " seconds, " +
+                             std::to_string(static_cast<std::size_t>(rate)) + " lines/s, " +
+                             std::to_string(stats.jobs) + " jobs");
+}
+
+/**
+ * @brief Prints the throughput and the latency measured by a load test
+ */
+
+void load_test_stats(const LoadTestStats &stats) {
+    auto rate = (stats.seconds > 0) ? static_cast<double>(stats.requests) / stats.seconds : 0.0;
+    Output::instance().error("Load test: " + std::to_string(stats.requests) + " requests, " +
+                             std::to_string(stats.connections) + " connections, " +
+                             std::to_string(stats.seconds) + " seconds, " +
+                             std::to_string(static_cast<std::size_t>(rate)) + " requests/s, p50 " +
+                             std::to_string(static_cast<std::size_t>(stats.p50)) + " us, p99 " +
+                             std::to_string(static_cast<std::size_t>(stats.p99)) + " us");
+}
+
+/**
+ * @brief Evaluates lines on a server and prints their replies
+ * @param client The connection to the server
+ * @param next Reads the next line, returns false when there are no more lines
+ * @return false if a line has raised an error, true otherwise
+ */
+
+bool remote_eval(Client &client, const std::function<bool(std::string&)> &next) {
+    auto &output = Output::instance();
+    std::string line;
+    std::string out;
+    std::string err;
+    bool failed = false;
+
+    while(next(line)) {
+        // The server closes the connection after a line quits
+        if(!client.request(line, out, err)) {
+            break;
+        }
+
+        output.write(out);
+        if(!err.empty()) {
+            // Errors are sent with their newlines
+            output.flush();
+            Output::write_all(STDERR_FILENO, err.data(), err.size());
+            failed = true;
+        } else if(output.is_line_buffered()) {
+            output.flush();
+        }
+    }
+
+    return !failed;
+}
+
 int main(int argc, char **argv) {
     int opt;
     const char *short_opts = "e:f:hV";
@@ -48,8 +182,23 @@ int main(int argc, char **argv) {
     std::string stdin_expression;
     bool execute_expression = false;
     bool execute_file = false;
-    Stack<std::string> stack;
-    std::unordered_map<char, Register> regs;
+    bool pipeline = false;
+    bool batch = false;
+    bool print_batch_stats = false;
+    std::size_t jobs = std::thread::hardware_concurrency();
+    std::string server_path;
+    std::string library_file;
+    std::string connect_path;
+    std::size_t load_requests = 0;
+    std::size_t connections = 1;
+    Stack<Value> stack;
+    RegisterFile regs;
+    // The output is flushed when it is destroyed, thus it must be created
+    // before registering the handlers that print statistics on exit
+    auto &output = Output::instance();
+    // Temporaries of the line being evaluated. The arena outlives main,
+    // thus its statistics can be printed on exit
+    static Arena arena;
     Parameters parameters = {
         .precision = 0,
         .iradix = 10,
@@ -58,6 +207,22 @@ int main(int argc, char **argv) {
     struct option long_opts[] = {
         {"expression", required_argument, nullptr, 'e'},
         {"file", required_argument, nullptr, 'f'},
+        {"cache-stats", no_argument, nullptr, 'C'},
+        {"arena-stats", no_argument, nullptr, 'A'},
+        {"no-arena", no_argument, nullptr, 'N'},
+        {"no-peephole", no_argument, nullptr, 'O'},
+        {"switch-dispatch", no_argument, nullptr, 'S'},
+        {"jit", no_argument, nullptr, 'J'},
+        {"line-buffered", no_argument, nullptr, 'B'},
+        {"pipeline", no_argument, nullptr, 'P'},
+        {"batch", no_argument, nullptr, 'b'},
+        {"jobs", required_argument, nullptr, 'j'},
+        {"batch-stats", no_argument, nullptr, 'T'},
+        {"server", required_argument, nullptr, 'D'},
+        {"library", required_argument, nullptr, 'L'},
+        {"connect", required_argument, nullptr, 'c'},
+        {"load-test", required_argument, nullptr, 'n'},
+        {"connections", required_argument, nullptr, 'k'},
         {"help", no_argument, nullptr, 'h'},
         {"version", no_argument, nullptr, 'V'},
         {nullptr, 0, nullptr, 0}
@@ -75,6 +240,89 @@ int main(int argc, char **argv) {
                 execute_file = true;
             }
             break;
+            case 'C': {
+                // Print statistics even when a macro quits the program.
+                // The cache must be constructed before registering the handler,
+                // otherwise it would be destroyed before the handler runs
+                MacroCache::instance();
+                std::atexit(cache_stats);
+            }
+            break;
+            case 'A': {
+                stats_arena = &arena;
+                std::atexit(arena_stats);
+            }
+            break;
+            case 'N': {
+                arena.set_enabled(false);
+            }
+            break;
+            case 'O': {
+                // Execute programs as they are written
+                Compiler::set_peephole(false);
+            }
+            break;
+            case 'S': {
+                // Jump back to a single switch after each instruction
+                Evaluate::set_threaded(false);
+            }
+            break;
+            case 'J': {
+                // Compile numeric macros when they enter the macro cache
+                Jit::set_enabled(true);
+            }
+            break;
+            case 'B': {
+                // Output is only line buffered on terminals by default
+                output.set_line_buffered(true);
+            }
+            break;
+            case 'P': {
+                pipeline = true;
+            }
+            break;
+            case 'b': {
+                batch = true;
+            }
+            break;
+            case 'j': {
+                auto max_jobs = Batch::MAX_JOBS_PER_CPU * std::max(std::thread::hardware_concurrency(), 1U);
+                auto count = parse_count(optarg, max_jobs);
+                if(!count) {
+                    output.error("Invalid number of jobs \"" + std::string(optarg) + "\", expected 1 to " +
+                                 std::to_string(max_jobs) + ".");
+                    return 1;
+                }
+                jobs = *count;
+            }
+            break;
+            case 'T': {
+                print_batch_stats = true;
+            }
+            break;
+            case 'D': {
+                server_path = std::string(optarg);
+            }
+            break;
+            case 'L': {
+                library_file = std::string(optarg);
+            }
+            break;
+            case 'c': {
+                connect_path = std::string(optarg);
+            }
+            break;
+            case 'n': case 'k': {
+                auto max = (opt == 'n') ? Client::MAX_REQUESTS : Client::MAX_CONNECTIONS;
+                auto count = parse_count(optarg, max);
+                if(!count) {
+                    output.error("Invalid number of " + std::string(opt == 'n' ? "requests" : "connections") +
+                                 " \"" + std::string(optarg) + "\", expected 1 to " + std::to_string(max) + ".");
+                    return 1;
+                }
+                (opt == 'n' ? load_requests : connections) = *count;
+            }
+            break;
             case 'V': {
                 version();
                 return 0;
@@ -84,60 +332,102 @@ int main(int argc, char **argv) {
         }
     }
 
+    // Serve sessions on a socket
+    if(!server_path.empty()) {
+        // Every session starts with the registers and the parameters of the library
+        Session library{{}, {}, parameters};
+        if(!library_file.empty()) {
+            Script script(library_file);
+            if(!script.is_open()) {
+                output.error("Cannot open source file \"" + library_file + "\".");
+                return 1;
+            }
+
+            auto err = script.eval(library.regs, library.stack, library.parameters, arena);
+            if(err != std::nullopt && !err->is_quit()) {
+                output.error(err->message());
+                return 1;
+            }
+        }
+
+        Server server(server_path, library, arena);
+        if(!server.is_open()) {
+            output.error("Cannot listen on socket \"" + server_path + "\".");
+            return 1;
+        }
+
+        output.flush();
+        server.run();
+        return 0;
+    }
+
+    // Evaluate stdin or cli expression on a server
+    if(!connect_path.empty()) {
+        auto expression = execute_expression ? cli_expression : std::string("1 2 + p");
+        if(load_requests > 0) {
+            auto stats = Client::load_test(connect_path, expression, load_requests, connections);
+            if(stats.requests == 0) {
+                output.error("Cannot connect to socket \"" + connect_path + "\".");
+                return 1;
+            }
+
+            load_test_stats(stats);
+            return 0;
+        }
+
+        Client client(connect_path);
+        if(!client.is_open()) {
+            output.error("Cannot connect to socket \"" + connect_path + "\".");
+            return 1;
+        }
+
+        if(execute_expression) {
+            // The expression is sent one line at a time
+            std::size_t begin = 0;
+            auto ok = remote_eval(client, [&](std::string &line) {
+                if(begin != 0 && begin >= cli_expression.size()) {
+                    return false;
+                }
+                auto end = std::min(cli_expression.find('\n', begin), cli_expression.size());
+                line.assign(cli_expression, begin, end - begin);
+                begin = end + 1;
+                return true;
+            });
+
+            return ok ? 0 : 1;
+        }
+
+        remote_eval(client, [](std::string &line) { return static_cast<bool>(std::getline(std::cin, line)); });
+        return 0;
+    }
+
     // Evaluate cli expression
     if(execute_expression) {
-        // Split string expression into a vector
-        std::vector<std::string> tokens = Macro::split(cli_expression);
         // Evaluate expression
-        Evaluate evaluator(tokens, regs, stack, parameters);
+        arena.reset();
+        Evaluate evaluator(cli_expression, regs, stack, parameters, &arena);
         auto err = evaluator.eval();
         // Handle errors
-        if(err != std::nullopt) {
-            std::cerr << err.value() << std::endl;
+        if(err != std::nullopt && !err->is_quit()) {
+            output.error(err->message());
             return 1;
         }
 
         return 0;
     } else if(execute_file) {
-        // Open file from disk
-        std::fstream source_file(file_name, std::ios::in | std::ios::binary);
-        if(source_file.fail()) {
-            std::cerr << "Cannot open source file \"" << file_name << "\"." << std::endl;
+        // Map file from disk
+        Script script(file_name);
+        if(!script.is_open()) {
+            output.error("Cannot open source file \"" + file_name + "\".");
             return 1;
         }
 
-        // Read whole file into a buffer
-        std::stringstream buf;
-        buf << source_file.rdbuf();
-
-        // Execute file line by line
-        std::string line;
-        while(std::getline(buf, line, '\n')) {
-            // Ignore comments or empty lines
-            if(line.empty() || line.starts_with('#')) {
-                continue;
-            }
-
-            // Remove inline comments
-            auto comment_pos = line.find('#');
-            std::vector<std::string> tokens;
-
-            if(comment_pos != std::string::npos) {
-                // Convert only the first part of the line
-                tokens = Macro::split(line.substr(0, comment_pos));
-            } else {
-                // Otherwise, convert the whole string
-                tokens = Macro::split(line);
-            }
-
-            // Evaluate expression
-            Evaluate evaluator(tokens, regs, stack, parameters);
-            auto err = evaluator.eval();
-            // Handle errors
-            if(err != std::nullopt) {
-                std::cerr << err.value() << std::endl;
-                return 1;
-            }
+        // Execute file statement by statement
+        auto err = script.eval(regs, stack, parameters, arena);
+        // Handle errors
+        if(err != std::nullopt && !err->is_quit()) {
+            output.error(err->message());
+            return 1;
         }
 
         return 0;
@@ -145,15 +435,43 @@ int main(int argc, char **argv) {
 
     
     // Otherwise, evaluate from stdin
-    while(std::getline(std::cin, stdin_expression)) {
-        // Split string expression into a vector
-        std::vector<std::string> tokens = Macro::split(stdin_expression);
+    if(batch) {
+        // Each line is a program on its own
+        Batch runner(jobs);
+        runner.run();
+        if(print_batch_stats) {
+            batch_stats(runner.stats());
+        }
+
+        return 0;
+    }
+
+    if(pipeline) {
+        Pipeline(regs, stack, parameters, arena).run();
+        return 0;
+    }
+
+    while(true) {
+        // On terminals, the output of a line is shown before the next one is read
+        if(output.is_line_buffered()) {
+            output.flush();
+        }
+
+        if(!std::getline(std::cin, stdin_expression)) {
+            break;
+        }
+
         // Evaluate expression
-        Evaluate evaluator(tokens, regs, stack, parameters);
+        arena.reset();
+        Evaluate evaluator(stdin_expression, regs, stack, parameters, &arena);
         auto err = evaluator.eval();
+        if(err != std::nullopt && err->is_quit()) {
+            break;
+        }
+
         // Handle errors
         if(err != std::nullopt) {
-            std::cerr << err.value() << std::endl;
+            output.error(err->message());
         }
     }
 
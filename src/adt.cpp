@@ -1,9 +1,7 @@
 #include <numeric>
+#include <algorithm>
 #include "adt.h"
 
-#define GET_X this->stack.back()
-#define GET_Y this->stack.at(this->stack.size() - 2)
-#define GET_Z this->stack.at(this->stack.size() - 3)
 
 namespace dc {
     /**
@@ -13,7 +11,7 @@ namespace dc {
     template<typename T>
     requires is_num_or_str<T>
     void Stack<T>::push(T value) {
-        this->stack.push_back(value);
+        this->stack.push_back(std::move(value));
     }
 
     /**
@@ -22,9 +20,11 @@ namespace dc {
     template<typename T>
     requires is_num_or_str<T>
     void Stack<T>::clear() {
-        if(!this->stack.empty()) {
-            this->stack.clear();
+        for(auto idx = this->stack.size(); idx > 0; idx--) {
+            save_last(idx - 1, true);
         }
+
+        this->stack.clear();
     }
 
     /**
@@ -38,33 +38,132 @@ namespace dc {
     template<typename T>
     requires is_num_or_str<T>
     T Stack<T>::pop(bool remove) {
-        T value = this->stack.back();
-
-        if(remove) {
-            this->stack.pop_back();
+        if(!remove) {
+            return this->stack.back();
         }
 
+        save_last(this->stack.size() - 1, false);
+        T value = std::move(this->stack.back());
+        this->stack.pop_back();
+
         return value;
     }
 
     /**
-     * @brief Copies the head, the 2nd and the 3rd 
-     * elements of the stack
+     * @brief Gets the head of the stack without copying it
+     *
+     * The reference is invalidated by any operation that modifies the stack
+     *
+     * @return The head of the stack
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    const T& Stack<T>::top() {
+        return this->stack.back();
+    }
+
+    /**
+     * @brief Removes the head of the stack without returning it
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    void Stack<T>::drop() {
+        save_last(this->stack.size() - 1, true);
+        this->stack.pop_back();
+    }
+
+    /**
+     * @brief Replaces the _nth_ element of the stack
+     * @param index The index of the element to replace
+     * @param value The new value of the element
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    void Stack<T>::set(std::size_t index, T value) {
+        save_last(index, true);
+        this->stack.at(index) = std::move(value);
+    }
+
+    /**
+     * @brief Swaps two elements of the stack
+     * @param lhs The index of the first element
+     * @param rhs The index of the second element
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    void Stack<T>::swap(std::size_t lhs, std::size_t rhs) {
+        save_last(lhs, false);
+        save_last(rhs, false);
+        std::swap(this->stack.at(lhs), this->stack.at(rhs));
+    }
+
+    /**
+     * @brief Marks the head, the 2nd and the 3rd elements
+     * of the stack as the last values
+     *
+     * The elements are not copied: they are saved only when they are
+     * about to be removed or replaced, which is the rare case of the
+     * elements that are not consumed by an operation. The last values that are
+     * not replaced are saved right away, since their elements might be replaced later
      */
     template<typename T>
     requires is_num_or_str<T>
     void Stack<T>::copy_xyz() {
-        if(this->stack.size() >= 1) {
-            this->last_x = GET_X;
+        auto count = std::min<std::size_t>(this->stack.size(), LAST_VALUES);
+        for(auto pos = count; pos < LAST_VALUES; pos++) {
+            if(this->pending & (1U << pos)) {
+                this->last_values[pos] = this->stack[this->mark - 1 - pos];
+            }
+        }
+
+        this->mark = this->stack.size();
+        this->pending = static_cast<std::uint8_t>((1U << count) - 1);
+    }
+
+    /**
+     * @brief Saves a last value whose element is about to be removed or replaced
+     * @param index The index of the element
+     * @param discard Whether the element is going to be discarded, and thus can be moved
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    void Stack<T>::save_last(std::size_t index, bool discard) {
+        if(index >= this->mark || this->mark - index > LAST_VALUES) {
+            return;
         }
 
-        if(this->stack.size() >= 2) {
-            this->last_y = GET_Y;
+        auto pos = this->mark - 1 - index;
+        if(this->pending & (1U << pos)) {
+            this->last_values[pos] = discard ? std::move(this->stack[index]) : this->stack[index];
+            this->pending &= static_cast<std::uint8_t>(~(1U << pos));
         }
+    }
 
-        if(this->stack.size() >= 3) {
-            this->last_z = GET_Z;
+    /**
+     * @brief Gets a last value, wherever it is stored
+     * @param pos The position of the last value(0 for _last x_, 1 for _last y_, 2 for _last z_)
+     * @return The last value
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    const T& Stack<T>::last_value(std::size_t pos) {
+        if(this->pending & (1U << pos)) {
+            return this->stack[this->mark - 1 - pos];
         }
+
+        return this->last_values[pos];
+    }
+
+    /**
+     * @brief Sets a last value, forgetting the element it was bound to
+     * @param pos The position of the last value(0 for _last x_, 1 for _last y_, 2 for _last z_)
+     * @param value The new last value
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    void Stack<T>::set_last_value(std::size_t pos, T value) {
+        this->last_values[pos] = std::move(value);
+        this->pending &= static_cast<std::uint8_t>(~(1U << pos));
     }
 
     /**
@@ -75,7 +174,7 @@ namespace dc {
     template<typename T>
     requires is_num_or_str<T>
     T Stack<T>::get_last_x() {
-        return this->last_x;
+        return last_value(0);
     }
 
     /**
@@ -86,7 +185,7 @@ namespace dc {
     template<typename T>
     requires is_num_or_str<T>
     T Stack<T>::get_last_y() {
-        return this->last_y;
+        return last_value(1);
     }
 
     /**
@@ -97,20 +196,51 @@ namespace dc {
     template<typename T>
     requires is_num_or_str<T>
     T Stack<T>::get_last_z() {
-        return this->last_z;
+        return last_value(2);
+    }
+
+    /**
+     * @brief Sets the _last x_ value of the stack
+     * @param value The new _last x_ value
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    void Stack<T>::set_last_x(T value) {
+        set_last_value(0, std::move(value));
+    }
+
+    /**
+     * @brief Sets the _last y_ value of the stack
+     * @param value The new _last y_ value
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    void Stack<T>::set_last_y(T value) {
+        set_last_value(1, std::move(value));
+    }
+
+    /**
+     * @brief Sets the _last z_ value of the stack
+     * @param value The new _last z_ value
+     */
+    template<typename T>
+    requires is_num_or_str<T>
+    void Stack<T>::set_last_z(T value) {
+        set_last_value(2, std::move(value));
     }
 
     /**
      * @brief Gets the _nth_ element of the stack
+     *
+     * Elements are replaced through Stack::set, so that last values are preserved
+     *
      * @param index The index of the element to get
      * @return The _nth_ value of the stack
      */
     template<typename T>
     requires is_num_or_str<T>
-    T& Stack<T>::at(std::size_t index) {
-        T &value = this->stack.at(index);
-
-        return value;
+    const T& Stack<T>::at(std::size_t index) {
+        return this->stack.at(index);
     }
 
     /**
@@ -120,7 +250,7 @@ namespace dc {
      */
     template<typename T>
     requires is_num_or_str<T>
-    T& Stack<T>::operator[](std::size_t index) {
+    const T& Stack<T>::operator[](std::size_t index) {
         return at(index);
     }
 
@@ -145,6 +275,8 @@ namespace dc {
             [](auto accumulator, const T& val) -> double {
                 if constexpr(std::is_same_v<T, std::string>) {
                     return accumulator + std::stod(val);
+                } else if constexpr(std::is_same_v<T, Value>) {
+                    return accumulator + val.to_double();
                 } else {
                     return accumulator + val;
                 }
@@ -164,6 +296,8 @@ namespace dc {
             [](auto accumulator, const T& val) -> double {
                 if constexpr(std::is_same_v<T, std::string>) {
                     return accumulator + (std::stod(val) * std::stod(val));
+                } else if constexpr(std::is_same_v<T, Value>) {
+                    return accumulator + (val.to_double() * val.to_double());
                 } else {
                     return accumulator + (val * val);
                 }
@@ -1,20 +1,26 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <array>
 #include <cstdint>
-#include <unordered_map>
+
+#include "value.h"
+#include "register_array.h"
 
 namespace dc {
     /**
-     * @brief Constrains a generic type to either integral/float types or to a string
+     * @brief Constrains a generic type to either integral/float types, to a string or to a DC value
      */
     template<typename T>
-    concept is_num_or_str = (std::is_arithmetic_v<T> || std::is_same_v<T, std::string>);
+    concept is_num_or_str = (std::is_arithmetic_v<T> || std::is_same_v<T, std::string> || std::is_same_v<T, Value>);
 
     /**
      * @brief Stack abstract data type
      * 
-     * Wraps the C++ std::vector container to create a stack-like data structure
+     * Wraps the C++ std::vector container to create a stack-like data structure.
+     * Values are moved in and out of the stack, while Stack::top gives access to
+     * the head without copying it. The last values(i.e., .x, .y, .z) are tracked lazily:
+     * Stack::copy_xyz only marks the elements, which are saved when they are removed or replaced
      */
     template<typename T>
     requires is_num_or_str<T>
@@ -24,11 +30,18 @@ namespace dc {
         void clear();
         void copy_xyz();
         T pop(bool remove);
+        const T& top();
+        void drop();
+        void set(std::size_t index, T value);
+        void swap(std::size_t lhs, std::size_t rhs);
         T get_last_x();
         T get_last_y();
         T get_last_z();
-        T& at(std::size_t index);
-        T& operator[](std::size_t index);
+        void set_last_x(T value);
+        void set_last_y(T value);
+        void set_last_z(T value);
+        const T& at(std::size_t index);
+        const T& operator[](std::size_t index);
         std::size_t size();
         double summation();
         double summation_squared();
@@ -36,21 +49,30 @@ namespace dc {
         [[nodiscard]] const std::vector<T>& get_ref() const;
 
     private:
+        static constexpr std::size_t LAST_VALUES = 3;
+
+        void save_last(std::size_t index, bool discard);
+        const T& last_value(std::size_t pos);
+        void set_last_value(std::size_t pos, T value);
+
         std::vector<T> stack;
-        T last_x{};
-        T last_y{};
-        T last_z{};
+        // Last x, last y and last z, unless they are still onto the stack
+        std::array<T, LAST_VALUES> last_values{};
+        // Size of the stack when the last values have been marked
+        std::size_t mark = 0;
+        // Bit _n_ is set if the _nth_ last value is the element at index **mark - 1 - n**
+        std::uint8_t pending = 0;
     };
     
     /**
      * @brief Register data structure
      * 
      * This abstract data type is made of an isolated stack, represented by the Stack data type, 
-     * and an array represented by an hashmap
+     * and an array represented by the RegisterArray data type
      */
     typedef struct {
-        Stack<std::string> stack;
-        std::unordered_map<int, std::string> array;
+        Stack<Value> stack;
+        RegisterArray array;
     } Register;
 
     enum class radix_base : std::uint8_t { BIN = 2, OCT = 8, DEC = 10, HEX = 16 };
@@ -0,0 +1,151 @@
+#include <algorithm>
+#ifdef DC_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#endif
+
+#include "arena.h"
+
+#ifdef DC_COUNT_ALLOCATIONS
+// Heap allocations of the process, counted by the replacements of the global
+// allocation functions below
+static std::atomic<std::size_t> heap_counter = 0;
+
+/**
+ * @brief Allocates memory from the heap, calling the new-handler until the allocation succeeds
+ * @param size The number of bytes
+ * @param align The alignment, zero for the default one
+ * @return The allocated memory
+ */
+static void *counted_alloc(std::size_t size, std::size_t align) {
+    heap_counter.fetch_add(1, std::memory_order_relaxed);
+    // The size of an aligned allocation must be a multiple of the alignment
+    size = (align == 0) ? std::max<std::size_t>(size, 1) : (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+
+    while(true) {
+        if(void *ptr = (align == 0) ? std::malloc(size) : std::aligned_alloc(align, size)) {
+            return ptr;
+        }
+
+        auto handler = std::get_new_handler();
+        if(handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void *operator new(std::size_t size) {
+    return counted_alloc(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+namespace dc {
+    /**
+     * @brief Creates an arena
+     * @param size The size of the preallocated buffer
+     */
+    Arena::Arena(std::size_t size)
+        : buffer(std::make_unique_for_overwrite<std::byte[]>(size)), pool(buffer.get(), size, &upstream),
+          heap_start(heap_allocations()) {}
+
+    /**
+     * @brief Releases every allocation of the previous line
+     *
+     * The preallocated buffer is kept, while the memory requested to the heap is released
+     */
+    void Arena::reset() {
+        this->pool.release();
+        this->high_water_mark = std::max(this->high_water_mark, this->line_bytes);
+        this->line_bytes = 0;
+        this->lines++;
+    }
+
+    /**
+     * @brief Retrieves the counters of the arena
+     * @return The number of lines, of allocations, the high-water mark and the heap allocations
+     */
+    ArenaStats Arena::stats() const {
+        std::optional<std::size_t> heap;
+        if(this->heap_start) {
+            heap = *heap_allocations() - *this->heap_start;
+        }
+
+        return ArenaStats{
+            .lines = this->lines,
+            .allocations = this->allocations,
+            .upstream_allocations = this->upstream.allocations,
+            .high_water_mark = std::max(this->high_water_mark, this->line_bytes),
+            .heap_allocations = heap
+        };
+    }
+
+    /**
+     * @brief Gets the number of heap allocations of the process
+     * @return The number of calls to the global operator new, std::nullopt if
+     * dc has not been built with DC_COUNT_ALLOCATIONS
+     */
+    std::optional<std::size_t> Arena::heap_allocations() {
+#ifdef DC_COUNT_ALLOCATIONS
+        return heap_counter.load(std::memory_order_relaxed);
+#else
+        return std::nullopt;
+#endif
+    }
+
+    void *Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+        this->allocations++;
+        this->line_bytes += bytes;
+        if(!this->enabled) {
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        return this->pool.allocate(bytes, alignment);
+    }
+
+    void Arena::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) {
+        // Memory of the pool is only released by Arena::reset
+        if(!this->enabled) {
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+    }
+
+    bool Arena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+        return this == &other;
+    }
+
+    void *Arena::Upstream::do_allocate(std::size_t bytes, std::size_t alignment) {
+        this->allocations++;
+
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void Arena::Upstream::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool Arena::Upstream::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+        return this == &other;
+    }
+}
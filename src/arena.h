@@ -0,0 +1,69 @@
+#pragma once
+#include <memory_resource>
+#include <memory>
+#include <optional>
+#include <cstddef>
+
+namespace dc {
+    /**
+     * @brief Counters of an arena
+     */
+    struct ArenaStats {
+        std::size_t lines;                  // Number of lines the arena has been reset for
+        std::size_t allocations;            // Allocations served by the arena
+        std::size_t upstream_allocations;   // Allocations the arena has requested to the heap
+        std::size_t high_water_mark;        // Largest number of bytes allocated by a single line
+        std::optional<std::size_t> heap_allocations; // Heap allocations of the process since the arena has been created,
+                                                     // only counted when built with DC_COUNT_ALLOCATIONS
+    };
+
+    /**
+     * @brief Monotonic allocator for the temporaries of an evaluation
+     *
+     * The compiled program of a line and the frame stack of the virtual machine live as long as
+     * the line is being evaluated, thus they are carved out of a preallocated buffer that is released
+     * at once when the next line is evaluated. Memory is only requested to the heap when a line does not
+     * fit into the buffer. The arena can be disabled, in which case allocations are forwarded
+     * to the heap, so that the counters of the two strategies can be compared.
+     *
+     * Objects allocated by the arena must be destroyed before resetting it
+     */
+    class Arena : public std::pmr::memory_resource {
+    public:
+        static constexpr std::size_t DEFAULT_SIZE = 64 * 1024;
+
+        explicit Arena(std::size_t size = DEFAULT_SIZE);
+        void reset();
+        void set_enabled(bool on) { this->enabled = on; }
+        [[nodiscard]] ArenaStats stats() const;
+        static std::optional<std::size_t> heap_allocations();
+
+    private:
+        /**
+         * @brief Heap resource counting the allocations requested by the arena
+         */
+        class Upstream : public std::pmr::memory_resource {
+        public:
+            std::size_t allocations = 0;
+
+        private:
+            void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+            void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+            [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+        };
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+        Upstream upstream;
+        std::unique_ptr<std::byte[]> buffer;
+        std::pmr::monotonic_buffer_resource pool;
+        bool enabled = true;
+        std::size_t lines = 0;
+        std::size_t allocations = 0;
+        std::size_t line_bytes = 0;
+        std::size_t high_water_mark = 0;
+        std::optional<std::size_t> heap_start;
+    };
+}
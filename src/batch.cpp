@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <utility>
+#include <array>
+#include <chrono>
+#include <cerrno>
+#include <unistd.h>
+
+#include "eval.h"
+#include "macro.h"
+#include "batch.h"
+
+/**
+ * @brief Constructor of Batch
+ * @param jobs The number of worker threads
+ */
+Batch::Batch(std::size_t jobs) : pool(jobs) {
+    for(std::size_t idx = 0; idx < this->pool.size(); idx++) {
+        this->contexts.push_back(std::make_unique<Context>());
+    }
+}
+
+/**
+ * @brief Evaluates the standard input until it is over
+ *
+ * While the workers evaluate a window, the next one is read and the results of the previous one are written
+ */
+void Batch::run() {
+    auto start = std::chrono::steady_clock::now();
+    // Lines cannot read from the standard input, since it holds the next lines
+    Macro::set_input([](std::string&) { return false; });
+
+    std::array<Window, 2> windows;
+    auto *current = &windows[0];
+    auto *next = &windows[1];
+    read_window(*current);
+    submit(*current);
+    while(!current->ends.empty()) {
+        read_window(*next);
+        this->pool.wait();
+        submit(*next);
+        emit(*current);
+        std::swap(current, next);
+    }
+
+    Macro::set_input(nullptr);
+    this->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Reads the next Batch::WINDOW_LINES lines, or whatever is left, from the standard input
+ *
+ * A line spanning two reads is carried over to the next window. The last line does not need to end with a newline
+ *
+ * @param window The window the lines are read into
+ * @return false when the standard input is over, true otherwise
+ */
+bool Batch::read_window(Window &window) {
+    window.text = std::move(this->carry);
+    window.ends.clear();
+    this->carry.clear();
+
+    while(!this->eof && window.ends.size() < WINDOW_LINES) {
+        auto offset = window.text.size();
+        window.text.resize(offset + READ_SIZE);
+        auto count = ::read(STDIN_FILENO, window.text.data() + offset, READ_SIZE);
+        if(count == -1 && errno == EINTR) {
+            window.text.resize(offset);
+            continue;
+        }
+
+        if(count <= 0) {
+            window.text.resize(offset);
+            this->eof = true;
+            break;
+        }
+
+        window.text.resize(offset + static_cast<std::size_t>(count));
+        for(auto pos = window.text.find('\n', offset); pos != std::string::npos; pos = window.text.find('\n', pos + 1)) {
+            window.ends.push_back(pos);
+        }
+    }
+
+    auto rest = window.ends.empty() ? 0 : window.ends.back() + 1;
+    if(this->eof) {
+        if(rest < window.text.size()) {
+            window.ends.push_back(window.text.size());
+        }
+    } else {
+        this->carry.assign(window.text, rest);
+        window.text.resize(rest);
+    }
+
+    return !window.ends.empty();
+}
+
+/**
+ * @brief Splits a window into tasks and hands them to the thread pool
+ * @param window The window to be evaluated
+ */
+void Batch::submit(Window &window) {
+    auto tasks = (window.ends.size() + TASK_LINES - 1) / TASK_LINES;
+    window.results.clear();
+    window.results.resize(tasks);
+    this->lines += window.ends.size();
+
+    for(std::size_t task = 0; task < tasks; task++) {
+        this->pool.submit([this, &window, task](std::size_t worker) {
+            evaluate(window, task, worker);
+        });
+    }
+}
+
+/**
+ * @brief Body of a task: evaluates a range of lines of a window, each one in a fresh state
+ * @param window The window the lines belong to
+ * @param task The index of the task, which evaluates the lines from task * Batch::TASK_LINES
+ * @param worker The index of the worker executing the task
+ */
+void Batch::evaluate(Window &window, std::size_t task, std::size_t worker) {
+    auto &ctx = *this->contexts[worker];
+    ctx.result = &window.results[task];
+    dc::Output::bind(&ctx.output);
+
+    auto end = std::min((task + 1) * TASK_LINES, window.ends.size());
+    for(auto idx = task * TASK_LINES; idx < end; idx++) {
+        auto offset = (idx == 0) ? 0 : window.ends[idx - 1] + 1;
+        auto line = std::string_view(window.text).substr(offset, window.ends[idx] - offset);
+
+        dc::Stack<dc::Value> stack;
+        dc::RegisterFile regs;
+        dc::Parameters parameters = {
+            .precision = 0,
+            .iradix = 10,
+            .oradix = dc::radix_base::DEC
+        };
+
+        ctx.arena.reset();
+        {
+            Evaluate evaluator(line, regs, stack, parameters, &ctx.arena);
+            auto err = evaluator.eval();
+            // Quitting only stops the current line
+            if(err != std::nullopt && !err->is_quit()) {
+                ctx.output.error(err->message());
+            }
+        }
+    }
+
+    ctx.output.flush();
+    dc::Output::bind(nullptr);
+}
+
+/**
+ * @brief Writes the results of a window in input order
+ * @param window The evaluated window
+ */
+void Batch::emit(Window &window) {
+    auto &output = dc::Output::instance();
+
+    for(const auto &blocks : window.results) {
+        for(const auto &block : blocks) {
+            if(block.fd == STDOUT_FILENO) {
+                output.write(block.data);
+            } else {
+                // Errors are captured with their newlines
+                output.flush();
+                dc::Output::write_all(block.fd, block.data.data(), block.data.size());
+            }
+        }
+    }
+}
+
+/**
+ * @brief Captures a block written by the line being evaluated
+ * @param fd The file descriptor the block must be written to
+ * @param data The content of the block
+ */
+void Batch::Context::write(int fd, std::string data) {
+    // Consecutive errors are merged into one block
+    if(!this->result->empty() && this->result->back().fd == fd && fd != STDOUT_FILENO) {
+        this->result->back().data += data;
+        return;
+    }
+
+    this->result->push_back(Block{fd, std::move(data)});
+}
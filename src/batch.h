@@ -0,0 +1,91 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include "arena.h"
+#include "output.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Counters of a batch evaluation
+ */
+struct BatchStats {
+    std::size_t lines;          // Number of lines evaluated
+    double seconds;             // Wall-clock time of the evaluation
+    std::size_t jobs;           // Number of worker threads
+};
+
+/**
+ * @brief Evaluates each line of the standard input as an independent program
+ *
+ * Every line starts with an empty stack, empty registers and the default parameters, thus lines do not depend on
+ * each other and are evaluated in parallel on a thread pool(see dc::ThreadPool). The standard input is read in windows
+ * of Batch::WINDOW_LINES lines, which are split into tasks of Batch::TASK_LINES lines. Each task captures the output
+ * and the errors of its lines, and the calling thread writes them in input order while the workers evaluate the next
+ * window. Reading from the standard input('?') fails, and quitting('q') only stops
+ * the line that quits
+ */
+class Batch {
+public:
+    explicit Batch(std::size_t jobs);
+    Batch(const Batch&) = delete;
+    Batch &operator=(const Batch&) = delete;
+    void run();
+    [[nodiscard]] BatchStats stats() const { return BatchStats{this->lines, this->seconds, this->pool.size()}; }
+
+    // Lines read before their evaluation starts
+    static constexpr std::size_t WINDOW_LINES = 16 * 1024;
+    // Lines evaluated by a single task
+    static constexpr std::size_t TASK_LINES = 64;
+    // Size of the reads from the standard input
+    static constexpr std::size_t READ_SIZE = 256 * 1024;
+    // Largest number of worker threads per hardware thread
+    static constexpr std::size_t MAX_JOBS_PER_CPU = 4;
+
+private:
+    /**
+     * @brief A block of output captured by a worker
+     */
+    struct Block {
+        int fd;
+        std::string data;
+    };
+
+    /**
+     * @brief Lines read from the standard input and their results
+     */
+    struct Window {
+        std::string text;
+        std::vector<std::size_t> ends;  // Offset of the end of each line
+        std::vector<std::vector<Block>> results;    // Output of each task, in order
+    };
+
+    /**
+     * @brief State of a worker, which captures the output of the task being executed
+     */
+    class Context : public dc::OutputSink {
+    public:
+        Context() : output(this) {}
+        void write(int fd, std::string data) override;
+        void close() override {}
+
+        dc::Arena arena;
+        dc::Output output;
+        std::vector<Block> *result = nullptr;
+    };
+
+    bool read_window(Window &window);
+    void submit(Window &window);
+    void evaluate(Window &window, std::size_t task, std::size_t worker);
+    void emit(Window &window);
+
+    dc::ThreadPool pool;
+    std::vector<std::unique_ptr<Context>> contexts;
+    std::string carry;
+    bool eof = false;
+    std::size_t lines = 0;
+    double seconds = 0;
+};
@@ -3,10 +3,9 @@
 
 #include "adt.cpp"
 #include "bitwise.h"
-#include "num_utils.h"
 
-std::optional<std::string> Bitwise::exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, __attribute__((unused))  std::unordered_map<char, dc::Register> &regs) {
-    std::optional<std::string> err = std::nullopt;
+std::optional<dc::Error> Bitwise::exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, __attribute__((unused))  dc::RegisterFile &regs) {
+    std::optional<dc::Error> err = std::nullopt;
 
     switch(this->op_type) {
         case OPType::BAND: err = fn_bitwise_and(stack, parameters); break;
@@ -32,30 +31,25 @@ std::optional<std::string> Bitwise::exec(dc::Stack<std::string> &stack, dc::Para
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Bitwise::fn_bitwise_and(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'{' requires two operands";
-    }
-
+std::optional<dc::Error> Bitwise::fn_bitwise_and(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size() - 1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        std::bitset<64> rhs{std::stoul(stack.pop(true))};
-        std::bitset<64> lhs{std::stoul(stack.pop(true))};
+        std::bitset<64> rhs{stack.pop(true).to_ulong()};
+        std::bitset<64> lhs{stack.pop(true).to_ulong()};
 
         // Compute bitwise AND and push back the result
         std::bitset<64> result = (lhs & rhs);
-        stack.push(NumericUtils::format_number(result.to_ullong(), parameters.precision));
+        stack.push(dc::Value(result.to_ullong(), parameters.precision));
     } else {
-        return "'{' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "{");
     }
 
     return std::nullopt;
@@ -72,30 +66,25 @@ std::optional<std::string> Bitwise::fn_bitwise_and(dc::Stack<std::string> &stack
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Bitwise::fn_bitwise_or(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'}' requires two operands";
-    }
-
+std::optional<dc::Error> Bitwise::fn_bitwise_or(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size() - 1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        std::bitset<64> rhs{std::stoul(stack.pop(true))};
-        std::bitset<64> lhs{std::stoul(stack.pop(true))};
+        std::bitset<64> rhs{stack.pop(true).to_ulong()};
+        std::bitset<64> lhs{stack.pop(true).to_ulong()};
 
         // Compute bitwise AND and push back the result
         std::bitset<64> result = (lhs | rhs);
-        stack.push(NumericUtils::format_number(result.to_ullong(), parameters.precision));
+        stack.push(dc::Value(result.to_ullong(), parameters.precision));
     } else {
-        return "'}' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "}");
     }
 
     return std::nullopt;
@@ -111,24 +100,19 @@ std::optional<std::string> Bitwise::fn_bitwise_or(dc::Stack<std::string> &stack,
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Bitwise::fn_bitwise_not(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'l' requires one operand";
-    }
-
+std::optional<dc::Error> Bitwise::fn_bitwise_not(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
-    auto x = stack.pop(false);
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
+    const auto& x = stack.top();
+    auto is_x_num = x.is_number();
 
     // Check whether popped value is a number
     if(is_x_num) {
         stack.copy_xyz();
         // Compute bitwise NOT 
-        int result = ~std::stoi(stack.pop(true));
-        stack.push(NumericUtils::format_number(result, parameters.precision));
+        int result = ~stack.pop(true).to_int();
+        stack.push(dc::Value(result, parameters.precision));
     } else {
-        return "'l' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "l");
     }
 
     return std::nullopt;
@@ -145,30 +129,25 @@ std::optional<std::string> Bitwise::fn_bitwise_not(dc::Stack<std::string> &stack
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Bitwise::fn_bitwise_xor(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'L' requires two operands";
-    }
-
+std::optional<dc::Error> Bitwise::fn_bitwise_xor(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size() - 1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        std::bitset<64> rhs{std::stoul(stack.pop(true))};
-        std::bitset<64> lhs{std::stoul(stack.pop(true))};
+        std::bitset<64> rhs{stack.pop(true).to_ulong()};
+        std::bitset<64> lhs{stack.pop(true).to_ulong()};
 
         // Compute bitwise AND and push back the result
         std::bitset<64> result = (lhs ^ rhs);
-        stack.push(NumericUtils::format_number(result.to_ullong(), parameters.precision));
+        stack.push(dc::Value(result.to_ullong(), parameters.precision));
     } else {
-        return "'L' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "L");
     }
 
     return std::nullopt;
@@ -185,30 +164,25 @@ std::optional<std::string> Bitwise::fn_bitwise_xor(dc::Stack<std::string> &stack
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Bitwise::fn_bitwise_lshift(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'m' requires two operands";
-    }
-
+std::optional<dc::Error> Bitwise::fn_bitwise_lshift(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size() - 1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        std::bitset<64> pos{std::stoul(stack.pop(true))};
-        std::bitset<64> value{std::stoul(stack.pop(true))};
+        std::bitset<64> pos{stack.pop(true).to_ulong()};
+        std::bitset<64> value{stack.pop(true).to_ulong()};
 
         // Compute bitwise left shift and push back the result
         std::bitset<64> result = (value << pos.to_ulong());
-        stack.push(NumericUtils::format_number(result.to_ullong(), parameters.precision));
+        stack.push(dc::Value(result.to_ullong(), parameters.precision));
     } else {
-        return "'m' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "m");
     }
 
     return std::nullopt;
@@ -225,30 +199,25 @@ std::optional<std::string> Bitwise::fn_bitwise_lshift(dc::Stack<std::string> &st
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Bitwise::fn_bitwise_rshift(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'M' requires two operands";
-    }
-
+std::optional<dc::Error> Bitwise::fn_bitwise_rshift(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size() - 1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        std::bitset<64> pos{std::stoul(stack.pop(true))};
-        std::bitset<64> value{std::stoul(stack.pop(true))};
+        std::bitset<64> pos{stack.pop(true).to_ulong()};
+        std::bitset<64> value{stack.pop(true).to_ulong()};
 
         // Compute bitwise right shift and push back the result
         std::bitset<64> result = (value >> pos.to_ulong());
-        stack.push(NumericUtils::format_number(result.to_ullong(), parameters.precision));
+        stack.push(dc::Value(result.to_ullong(), parameters.precision));
     } else {
-        return "'M' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "M");
     }
 
     return std::nullopt;
@@ -18,19 +18,19 @@ public:
      * 
      * @param stack An instance of the dc::Stack data structure
      * @param parameters An instance of the dc::Parameters data structure
-     * @param regs An instance of the dc::Register data structure
+     * @param regs An instance of the dc::RegisterFile data structure
      * 
      * @return Runtime errors, if any
      */
-    std::optional<std::string> exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) override;
+    std::optional<dc::Error> exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) override;
 
 private:
-    std::optional<std::string> fn_bitwise_and(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    std::optional<std::string> fn_bitwise_or(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    std::optional<std::string> fn_bitwise_not(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    std::optional<std::string> fn_bitwise_xor(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    std::optional<std::string> fn_bitwise_lshift(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    std::optional<std::string> fn_bitwise_rshift(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_bitwise_and(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_bitwise_or(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_bitwise_not(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_bitwise_xor(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_bitwise_lshift(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_bitwise_rshift(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
 
     OPType op_type;
 };
@@ -0,0 +1,171 @@
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "client.h"
+
+/**
+ * @brief Constructor of Client, which connects to the server
+ * @param socket_path The path of the socket of the server
+ */
+Client::Client(const std::string &socket_path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if(socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+        return;
+    }
+    std::memcpy(addr.sun_path, socket_path.data(), socket_path.size());
+
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(sock == -1) {
+        return;
+    }
+
+    if(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+        ::close(sock);
+        return;
+    }
+
+    this->fd = sock;
+}
+
+Client::~Client() {
+    if(this->fd != -1) {
+        ::close(this->fd);
+    }
+}
+
+/**
+ * @brief Evaluates a line on the server
+ * @param line The line to be evaluated, without the newline
+ * @param out The output of the line
+ * @param err The errors of the line
+ * @return false if the server has closed the connection(e.g., the line has quit), true otherwise
+ */
+bool Client::request(std::string_view line, std::string &out, std::string &err) {
+    std::string message(line);
+    message.push_back('\n');
+
+    std::size_t offset = 0;
+    while(offset < message.size()) {
+        auto count = send(this->fd, message.data() + offset, message.size() - offset, MSG_NOSIGNAL);
+        if(count == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        offset += static_cast<std::size_t>(count);
+    }
+
+    // The reply starts with the sizes of the output and of the errors
+    std::size_t header_end;
+    while((header_end = this->buffer.find('\n')) == std::string::npos) {
+        if(!receive(this->buffer.size() + 1)) {
+            return false;
+        }
+    }
+
+    std::size_t out_size = 0;
+    std::size_t err_size = 0;
+    if(std::sscanf(this->buffer.c_str(), "%zu %zu", &out_size, &err_size) != 2) {
+        return false;
+    }
+
+    auto body = header_end + 1;
+    if(!receive(body + out_size + err_size)) {
+        return false;
+    }
+
+    out.assign(this->buffer, body, out_size);
+    err.assign(this->buffer, body + out_size, err_size);
+    this->buffer.erase(0, body + out_size + err_size);
+
+    return true;
+}
+
+/**
+ * @brief Reads from the server until the buffer holds at least **size** bytes
+ * @param size The number of bytes
+ * @return false if the connection has been closed first, true otherwise
+ */
+bool Client::receive(std::size_t size) {
+    std::array<char, 64 * 1024> chunk{};
+
+    while(this->buffer.size() < size) {
+        auto count = ::read(this->fd, chunk.data(), chunk.size());
+        if(count == -1 && errno == EINTR) {
+            continue;
+        }
+        if(count <= 0) {
+            return false;
+        }
+        this->buffer.append(chunk.data(), static_cast<std::size_t>(count));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Measures the throughput and the latency of a server
+ *
+ * Each connection runs on its own thread and sends its share of the requests one at a time,
+ * waiting for the reply of each request before sending the next one
+ *
+ * @param socket_path The path of the socket of the server
+ * @param line The line sent by every request
+ * @param requests The total number of requests
+ * @param connections The number of concurrent connections, at least one
+ * @return The results of the test
+ */
+LoadTestStats Client::load_test(const std::string &socket_path, std::string_view line,
+                                std::size_t requests, std::size_t connections) {
+    // Connections without requests are not opened
+    connections = std::min(connections, requests);
+    std::vector<std::vector<double>> latencies(connections);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for(std::size_t idx = 0; idx < connections; idx++) {
+        auto share = requests / connections + (idx < requests % connections ? 1 : 0);
+        threads.emplace_back([&socket_path, line, share, &samples = latencies[idx]] {
+            Client client(socket_path);
+            std::string out;
+            std::string err;
+            samples.reserve(share);
+            for(std::size_t req = 0; client.is_open() && req < share; req++) {
+                auto sent = std::chrono::steady_clock::now();
+                if(!client.request(line, out, err)) {
+                    return;
+                }
+                auto elapsed = std::chrono::steady_clock::now() - sent;
+                samples.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+            }
+        });
+    }
+
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for(const auto &samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    auto percentile = [&all](double rank) {
+        return all.empty() ? 0.0 : all[static_cast<std::size_t>(rank * static_cast<double>(all.size() - 1))];
+    };
+
+    return LoadTestStats{all.size(), connections, seconds, percentile(0.50), percentile(0.99)};
+}
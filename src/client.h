@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @brief Results of a load test, see Client::load_test
+ */
+struct LoadTestStats {
+    std::size_t requests;       // Number of requests answered
+    std::size_t connections;    // Number of concurrent connections
+    double seconds;             // Wall-clock time of the test
+    double p50;                 // Median latency, in microseconds
+    double p99;                 // 99th percentile of the latency, in microseconds
+};
+
+/**
+ * @brief A connection to a DC server
+ *
+ * Sends lines of DC code to a Server and waits for their replies, one line at a time
+ */
+class Client {
+public:
+    explicit Client(const std::string &socket_path);
+    Client(const Client&) = delete;
+    Client &operator=(const Client&) = delete;
+    ~Client();
+
+    /**
+     * @brief Returns true if the client is connected, false otherwise
+     * @return Boolean value
+     */
+    [[nodiscard]] bool is_open() const { return this->fd != -1; }
+    bool request(std::string_view line, std::string &out, std::string &err);
+    static LoadTestStats load_test(const std::string &socket_path, std::string_view line,
+                                   std::size_t requests, std::size_t connections);
+
+    // Largest number of requests of a load test
+    static constexpr std::size_t MAX_REQUESTS = 100'000'000;
+    // Largest number of connections of a load test, each one has its own thread
+    static constexpr std::size_t MAX_CONNECTIONS = 1024;
+
+private:
+    bool receive(std::size_t size);
+
+    int fd = -1;
+    std::string buffer;     // Received bytes not yet consumed
+};
@@ -0,0 +1,628 @@
+#include <cctype>
+#include <optional>
+
+#include "adt.cpp"
+#include "compiler.h"
+#include "environment.h"
+#include "macro.h"
+
+#define WHITESPACES " \t\n\v\f\r"
+#define MACRO_CMD_COND(VAL) ((VAL.length() == 2 || VAL.length() == 3) && \
+              (VAL.at(0) == '>' || VAL.at(0) == '<' || \
+               VAL.at(0) == '=' || VAL.at(0) == '!'))
+#define REGISTER_COND(VAL) ((VAL.length() == 2) && \
+              (VAL.at(0) == 's' || VAL.at(0) == 'S' || \
+               VAL.at(0) == 'l' || VAL.at(0) == 'L' || \
+               VAL.at(0) == 'c' || VAL.at(0) == 'z'))
+#define ARRAY_COND(VAL) ((VAL.length() == 2) && \
+        (VAL.at(0) == ':' || VAL.at(0) == ';'))
+#define IS_OPERATION(INSTR, TYPE) ((INSTR).opcode == OpCode::OPERATION && \
+              (INSTR).operand == static_cast<std::uint32_t>(OPType::TYPE))
+
+static bool peephole_enabled = true;
+
+/**
+ * @brief Compiles the source code of a DC program
+ *
+ * The source code is copied once into a shared buffer, which is then
+ * referenced by the literals of the program
+ *
+ * @param source The source code to be compiled
+ * @param parameters The parameters constant sequences are folded with
+ * @param resource The memory resource the program is allocated by
+ * @return The compiled program
+ */
+Program Compiler::compile(std::string_view source, const dc::Parameters &parameters, std::pmr::memory_resource *resource) {
+    return compile(dc::SharedString::copy(source), parameters, resource);
+}
+
+/**
+ * @brief Overload of compile for shared source code(e.g., the body of a macro)
+ *
+ * Literals and macros are slices of the source code, thus they are not copied
+ *
+ * @param source The source code to be compiled
+ * @param parameters The parameters constant sequences are folded with
+ * @param resource The memory resource the program is allocated by
+ * @return The compiled program
+ */
+Program Compiler::compile(const dc::SharedString &source, const dc::Parameters &parameters, std::pmr::memory_resource *resource) {
+    Program program(resource);
+    Lexer lexer(source.view());
+
+    while(auto next = lexer.next()) {
+        if(next->kind != Token::Kind::WORD) {
+            // A malformed macro stops the evaluation, there is no point
+            // in compiling the rest of the program
+            if(!compile_macro(program, source, next.value())) {
+                break;
+            }
+            continue;
+        }
+
+        auto token = next->text;
+        if(auto op_type = Environment::find(token); op_type == OPType::EX) {
+            // Macro calls are scheduled by the virtual machine itself
+            program.code.push_back({OpCode::EXEC, 0, 0, 0});
+        } else if(op_type != std::nullopt) {
+            program.code.push_back({OpCode::OPERATION, 0, 0, static_cast<std::uint32_t>(op_type.value())});
+        } else if(token == "q") {
+            program.code.push_back({OpCode::QUIT, 0, 0, 0});
+        } else if(MACRO_CMD_COND(token)) {
+            compile_macro_command(program, token);
+        } else if(REGISTER_COND(token)) {
+            compile_register_command(program, token);
+        } else if(ARRAY_COND(token)) {
+            compile_array_command(program, token);
+        } else {
+            // Anything else is a literal. Whether it is a valid one depends on
+            // the input radix, thus it is checked by the virtual machine
+            program.code.push_back({OpCode::PUSH, 0, 0, add_literal(program, source.slice(token))});
+        }
+    }
+
+    analyze(program);
+    fold(program, parameters);
+    if(peephole_enabled) {
+        optimize(program);
+    }
+
+    return program;
+}
+
+/**
+ * @brief Enables or disables the peephole pass
+ *
+ * Programs that have already been compiled(e.g., cached macros) are not affected
+ *
+ * @param enabled Whether superinstructions should be generated
+ */
+void Compiler::set_peephole(bool enabled) {
+    peephole_enabled = enabled;
+}
+
+/**
+ * @brief Computes the stack effect of an instruction
+ *
+ * Literals that are not numbers might be valid numbers of another input
+ * radix, thus their effect is unknown
+ *
+ * @param program The program the instruction belongs to
+ * @param instr The instruction
+ * @return The stack effect, std::nullopt if it is unknown
+ */
+static std::optional<StackEffect> instruction_effect(const Program &program, const Instruction &instr) {
+    switch(instr.opcode) {
+        case OpCode::OPERATION: return Environment::stack_effect(static_cast<OPType>(instr.operand));
+        case OpCode::PUSH: {
+            if(!program.literals[instr.operand].is_number()) {
+                return std::nullopt;
+            }
+            return StackEffect{0, 1, ""};
+        }
+        case OpCode::PUSH_MACRO:
+        case OpCode::POP_REG:
+        case OpCode::LOAD:
+        case OpCode::REG_SIZE: return StackEffect{0, 1, ""};
+        case OpCode::CLEAR_REG: return StackEffect{0, 0, ""};
+        case OpCode::STORE:
+        case OpCode::PUSH_REG: return StackEffect{1, 0, "This operation does not work on empty stack"};
+        case OpCode::ARRAY_STORE: return StackEffect{2, 0, "This operation requires two values"};
+        case OpCode::ARRAY_LOAD: return StackEffect{1, 1, "This operation requires one value"};
+        case OpCode::EXEC: return StackEffect{1, StackEffect::VARIABLE, "This operation does not work on empty stack"};
+        case OpCode::CMP: return StackEffect{2, StackEffect::VARIABLE, "This operation requires two elements"};
+        default: return std::nullopt;
+    }
+}
+
+/**
+ * @brief Computes the depth of the stack required by the straight-line prefix of a program
+ *
+ * Within the prefix, the depth of the stack is known relative to the depth the program is entered with.
+ * The prefix ends after the first instruction whose effect depends on the runtime state(e.g., a macro call),
+ * or before the first instruction whose effect is unknown. When the program is entered with a stack at least
+ * as deep, no operation of the prefix can underflow, thus the virtual machine skips their checks. Otherwise,
+ * every operation is checked when it is dispatched, so that the error is raised by the instruction that
+ * underflows, after the previous ones have been executed
+ *
+ * @param program The program to be analyzed
+ */
+void Compiler::analyze(Program &program) {
+    // Number of elements pushed since the entry of the program
+    std::ptrdiff_t offset = 0;
+    std::size_t idx = 0;
+
+    while(idx < program.code.size()) {
+        auto effect = instruction_effect(program, program.code[idx]);
+        if(!effect) {
+            break;
+        }
+        idx++;
+
+        auto depth = static_cast<std::ptrdiff_t>(effect->operands) - offset;
+        if(depth > 0 && static_cast<std::size_t>(depth) > program.prefix_depth) {
+            program.prefix_depth = static_cast<std::size_t>(depth);
+        }
+
+        if(effect->results == StackEffect::VARIABLE) {
+            break;
+        }
+        offset += effect->results - static_cast<std::ptrdiff_t>(effect->operands);
+    }
+
+    program.prefix_length = idx;
+}
+
+/**
+ * @brief Returns true if an instruction is an operation whose result only depends on
+ * its operands and on the precision, false otherwise
+ *
+ * '~' is not pure in this sense: it truncates the divisor to an integer, which
+ * might be zero. Operations whose cost grows with the value of their operands('!', 'gP',
+ * 'gC' and '|') are not folded either: the sequence might never be reached, and the
+ * compiler must not hang on it
+ *
+ * @param instr The instruction to be checked
+ * @return Boolean value
+ */
+static bool is_pure(const Instruction &instr) {
+    if(instr.opcode != OpCode::OPERATION) {
+        return false;
+    }
+
+    switch(static_cast<OPType>(instr.operand)) {
+        case OPType::ADD: case OPType::SUB: case OPType::MUL: case OPType::DIV:
+        case OPType::MOD: case OPType::EXP: case OPType::SQRT: case OPType::SIN:
+        case OPType::COS: case OPType::TAN: case OPType::ASIN: case OPType::ACOS:
+        case OPType::ATAN: case OPType::PI: case OPType::E: case OPType::INT:
+        case OPType::TO_CMPLX: case OPType::GET_RE: case OPType::GET_IM: case OPType::LOG:
+        case OPType::BAND: case OPType::BOR: case OPType::BNOT: case OPType::BXOR:
+        case OPType::BSL: case OPType::BSR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Returns true if the parameters(i.e., the precision and the radixes) might
+ * have changed after an instruction, false otherwise
+ *
+ * Macros and input can execute arbitrary code
+ *
+ * @param instr The instruction to be checked
+ * @return Boolean value
+ */
+static bool may_change_parameters(const Instruction &instr) {
+    if(instr.opcode == OpCode::EXEC || instr.opcode == OpCode::CMP) {
+        return true;
+    }
+
+    if(instr.opcode != OpCode::OPERATION) {
+        return false;
+    }
+
+    switch(static_cast<OPType>(instr.operand)) {
+        case OPType::SP: case OPType::SIR: case OPType::SOR:
+        case OPType::RI: case OPType::LF:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Creates the stack a folded sequence is evaluated on
+ *
+ * The elements below the sequence and the previous last values are
+ * markers, which are traced into the last values set by the operations
+ *
+ * @param depth The number of elements below the sequence
+ * @return The stack
+ */
+static dc::Stack<dc::Value> fold_stack(std::size_t depth) {
+    dc::Stack<dc::Value> stack;
+    stack.push(dc::Value(std::string("#z")));
+    stack.push(dc::Value(std::string("#y")));
+    stack.push(dc::Value(std::string("#x")));
+    stack.copy_xyz();
+    stack.clear();
+
+    for(auto idx = depth; idx > 0; idx--) {
+        stack.push(dc::Value("#" + std::to_string(idx - 1)));
+    }
+
+    return stack;
+}
+
+/**
+ * @brief Traces a last value back to its source
+ * @param value The last value set by a folded sequence
+ * @return The effect of the sequence on the last value
+ */
+static Fold::LastValue trace_last_value(const dc::Value &value) {
+    auto text = value.to_string();
+    if(value.kind() != dc::Value::Kind::STRING || !text.starts_with('#')) {
+        return {Fold::LastValue::Source::CONSTANT, 0, value};
+    }
+
+    if(text == "#x" || text == "#y" || text == "#z") {
+        return {Fold::LastValue::Source::KEEP, 0, dc::Value()};
+    }
+
+    return {Fold::LastValue::Source::STACK, static_cast<std::size_t>(text[1] - '0'), dc::Value()};
+}
+
+/**
+ * @brief Folds sequences of literals and pure operations into their results
+ *
+ * Literals depend on the input radix and results depend on the precision, thus
+ * sequences are only folded as long as the parameters are known at compile time.
+ * The virtual machine checks that the precision has not changed before using the results
+ *
+ * @param program The program to be optimized
+ * @param parameters The parameters the program is compiled with
+ */
+void Compiler::fold(Program &program, const dc::Parameters &parameters) {
+    if(parameters.iradix != 10) {
+        return;
+    }
+
+    for(std::size_t idx = 0; idx < program.code.size(); idx++) {
+        if(may_change_parameters(program.code[idx])) {
+            return;
+        }
+
+        if(auto length = fold_sequence(program, idx, parameters); length != 0) {
+            idx += length - 1;
+        }
+    }
+}
+
+/**
+ * @brief Folds the longest sequence of literals and pure operations starting at an instruction
+ *
+ * The sequence is evaluated by the operations themselves, for each depth of the stack. Like
+ * superinstructions, the folded sequence replaces its first instruction only, so that the virtual
+ * machine can fall back to the original instructions when the precision has changed
+ *
+ * @param program The program to be optimized
+ * @param begin The index of the first instruction of the sequence
+ * @param parameters The parameters the program is compiled with
+ * @return The length of the folded sequence, 0 if nothing has been folded
+ */
+std::size_t Compiler::fold_sequence(Program &program, std::size_t begin, const dc::Parameters &parameters) {
+    // Sequences are made of literals followed by at least one operation: skip
+    // the literals before evaluating anything
+    auto first_op = begin;
+    while(first_op < program.code.size() && program.code[first_op].opcode == OpCode::PUSH
+          && program.literals[program.code[first_op].operand].is_number()) {
+        first_op++;
+    }
+
+    if(first_op == program.code.size() || !is_pure(program.code[first_op])) {
+        return 0;
+    }
+
+    // The markers are only created once, while the stacks the sequence is evaluated on
+    // are reused by every sequence the thread folds, so that their buffers are only allocated once
+    static const auto initial_stacks = [] {
+        std::array<dc::Stack<dc::Value>, Fold::MAX_DEPTH + 1> res;
+        for(std::size_t depth = 0; depth <= Fold::MAX_DEPTH; depth++) {
+            res[depth] = fold_stack(depth);
+        }
+
+        return res;
+    }();
+    static thread_local std::array<dc::Stack<dc::Value>, Fold::MAX_DEPTH + 1> stacks, folded;
+    stacks = initial_stacks;
+    folded = initial_stacks;
+
+    // Pure operations do not use registers
+    dc::RegisterFile regs;
+    auto params = parameters;
+    std::size_t length = 0;
+
+    for(auto idx = begin; idx < program.code.size(); idx++) {
+        const auto &instr = program.code[idx];
+        if(instr.opcode == OpCode::PUSH && program.literals[instr.operand].is_number()) {
+            for(auto &stack : stacks) {
+                stack.push(program.literals[instr.operand]);
+            }
+            continue;
+        }
+
+        if(!is_pure(instr)) {
+            break;
+        }
+
+        // An operation that fails(e.g., missing operands) ends the sequence
+        auto op_type = static_cast<OPType>(instr.operand);
+        auto &operation = Environment::operation(op_type);
+        bool failed = false;
+        for(auto &stack : stacks) {
+            if(stack.size() < Environment::stack_effect(op_type).operands) {
+                failed = true;
+                continue;
+            }
+
+            try {
+                failed = failed || operation.exec(stack, params, regs).has_value();
+            } catch(...) {
+                failed = true;
+            }
+        }
+
+        if(failed) {
+            break;
+        }
+
+        folded = stacks;
+        length = idx - begin + 1;
+    }
+
+    if(length == 0) {
+        return 0;
+    }
+
+    const auto &results = folded[0].get_ref();
+    Fold sequence{program.code[begin], length, parameters.precision,
+                  std::pmr::vector<dc::Value>(results.begin(), results.end(), program.folds.get_allocator()), {}};
+    for(std::size_t depth = 0; depth <= Fold::MAX_DEPTH; depth++) {
+        // Operations must not have touched the elements below the sequence
+        if(folded[depth].size() != depth + sequence.results.size()) {
+            return 0;
+        }
+
+        sequence.last_values[depth] = {trace_last_value(folded[depth].get_last_x()),
+                                   trace_last_value(folded[depth].get_last_y()),
+                                   trace_last_value(folded[depth].get_last_z())};
+    }
+
+    program.folds.push_back(std::move(sequence));
+    program.code[begin] = {OpCode::FOLD, 0, 0, static_cast<std::uint32_t>(program.folds.size() - 1)};
+
+    return length;
+}
+
+/**
+ * @brief Fuses common sequences of instructions into superinstructions
+ *
+ * A superinstruction replaces the first instruction of the sequence, while the
+ * others are left in place: when its operands do not allow the fast path(e.g., a string
+ * on the stack or an empty stack), the virtual machine falls back to the first instruction
+ * and goes on with the rest of the sequence, yielding the same results and the same errors.
+ * Sequences are matched against the original code, thus they might overlap
+ *
+ * @param program The program to be optimized
+ */
+void Compiler::optimize(Program &program) {
+    const std::pmr::vector<Instruction> code(program.code, program.code.get_allocator());
+
+    for(std::size_t idx = 0; idx + 1 < code.size(); idx++) {
+        const auto &first = code[idx];
+        const auto &second = code[idx + 1];
+        auto &fused = program.code[idx];
+
+        if(IS_OPERATION(first, DP) && IS_OPERATION(second, MUL)) {
+            fused.opcode = OpCode::DUP_MUL;
+        } else if(first.opcode == OpCode::PUSH && program.literals[first.operand].is_number()
+                  && (IS_OPERATION(second, ADD) || IS_OPERATION(second, SUB))) {
+            fused.opcode = IS_OPERATION(second, ADD) ? OpCode::PUSH_ADD : OpCode::PUSH_SUB;
+        } else if(IS_OPERATION(first, SO) && IS_OPERATION(second, SUB)) {
+            fused.opcode = OpCode::SWAP_SUB;
+        } else if(first.opcode == OpCode::STORE && second.opcode == OpCode::LOAD && first.reg == second.reg) {
+            fused.opcode = OpCode::STORE_LOAD;
+        } else if(first.opcode == OpCode::LOAD && second.opcode == OpCode::LOAD
+                  && idx + 2 < code.size() && code[idx + 2].opcode == OpCode::CMP) {
+            // Both register names and the comparison are stored into the superinstruction
+            const auto &cmp = code[idx + 2];
+            fused = {OpCode::CMP_REGS, first.reg, cmp.aux,
+                     static_cast<std::uint32_t>(static_cast<unsigned char>(second.reg)) << 8
+                     | static_cast<unsigned char>(cmp.reg)};
+        } else if(first.opcode == OpCode::LOAD && second.opcode == OpCode::EXEC) {
+            fused.opcode = OpCode::LOAD_EXEC;
+        }
+    }
+}
+
+/**
+ * @brief Gets the first instruction replaced by a superinstruction
+ * @param program The program the superinstruction belongs to
+ * @param instr The superinstruction
+ * @return The instruction the virtual machine falls back to
+ */
+Instruction Compiler::unfuse(const Program &program, const Instruction &instr) {
+    switch(instr.opcode) {
+        case OpCode::DUP_MUL: return {OpCode::OPERATION, 0, 0, static_cast<std::uint32_t>(OPType::DP)};
+        case OpCode::PUSH_ADD:
+        case OpCode::PUSH_SUB: return {OpCode::PUSH, 0, 0, instr.operand};
+        case OpCode::SWAP_SUB: return {OpCode::OPERATION, 0, 0, static_cast<std::uint32_t>(OPType::SO)};
+        case OpCode::STORE_LOAD: return {OpCode::STORE, instr.reg, 0, 0};
+        case OpCode::LOAD_EXEC:
+        case OpCode::CMP_REGS: return {OpCode::LOAD, instr.reg, 0, 0};
+        case OpCode::FOLD: return program.folds[instr.operand].original;
+        default: return instr;
+    }
+}
+
+/**
+ * @brief Appends a value to the literal pool of a program
+ * @param program The program being compiled
+ * @param literal The literal value
+ * @return The index of the literal
+ */
+std::uint32_t Compiler::add_literal(Program &program, dc::SharedString literal) {
+    program.literals.emplace_back(std::move(literal));
+
+    return static_cast<std::uint32_t>(program.literals.size() - 1);
+}
+
+/**
+ * @brief Checks whether the tokens of a string are separated by single spaces
+ * @param str The string to be checked
+ * @return true if there are no other whitespaces, false otherwise
+ */
+static bool is_collapsed(std::string_view str) {
+    bool prev_space = false;
+    for(auto c : str) {
+        bool space = std::isspace(static_cast<unsigned char>(c));
+        if(space && (prev_space || c != ' ')) {
+            return false;
+        }
+        prev_space = space;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compiles a DC macro
+ *
+ * Whitespaces are collapsed, so that a macro does not depend on the formatting
+ * of the source code, except for the newlines that end a comment. Macros that are already in this form(e.g., nested macros, whose
+ * enclosing macro has been collapsed already) are slices of the source code
+ *
+ * @param program The program being compiled
+ * @param source The source code of the program
+ * @param token The string token holding the macro
+ * @return false if the macro is malformed, true otherwise
+ */
+bool Compiler::compile_macro(Program &program, const dc::SharedString &source, const Token &token) {
+    // Check if macro is properly formatted
+    if(token.kind == Token::Kind::UNBALANCED) {
+        program.code.push_back({OpCode::ERROR, 0, 0, static_cast<std::uint32_t>(dc::ErrorCode::UNBALANCED_PARENTHESIS)});
+        return false;
+    }
+
+    auto body = token.text;
+    auto first = body.find_first_not_of(WHITESPACES);
+    body = (first == std::string_view::npos) ? std::string_view{} : body.substr(first, body.find_last_not_of(WHITESPACES) - first + 1);
+
+    // Check if macro is empty
+    if(body.empty()) {
+        program.code.push_back({OpCode::ERROR, 0, 0, static_cast<std::uint32_t>(dc::ErrorCode::EMPTY_MACRO)});
+        return false;
+    }
+
+    // Tokens separated by single spaces do not need to be collapsed
+    if(is_collapsed(body)) {
+        program.code.push_back({OpCode::PUSH_MACRO, 0, 0, add_literal(program, source.slice(body))});
+        return true;
+    }
+
+    // Newlines ending a comment are kept, otherwise the comment would swallow the rest of the macro
+    std::string dc_macro;
+    bool pending_space = false, pending_newline = false, comment = false;
+    for(auto c : body) {
+        if(std::isspace(static_cast<unsigned char>(c))) {
+            pending_space = true;
+            pending_newline = pending_newline || (c == '\n' && comment);
+            continue;
+        }
+
+        if(pending_space) {
+            dc_macro += pending_newline ? '\n' : ' ';
+            comment = comment && !pending_newline;
+            pending_space = pending_newline = false;
+        }
+        comment = comment || c == '#';
+        dc_macro += c;
+    }
+
+    program.code.push_back({OpCode::PUSH_MACRO, 0, 0, add_literal(program, dc::SharedString(dc_macro))});
+
+    return true;
+}
+
+/**
+ * @brief Compiles a DC macro command
+ *
+ * A macro command is a comparison symbol(>, <, =, >=, <=, !=)
+ * followed by a register name(e.g, >A)
+ *
+ * @param program The program being compiled
+ * @param token The comparison symbol followed by the register name
+ */
+void Compiler::compile_macro_command(Program &program, std::string_view token) {
+    // If command has length equal to three, then it's either '<=', '>=' or '!='
+    std::string_view operation;
+    char dc_register = 0;
+    if(token.length() == 3) {
+        operation = token.substr(0, 2);
+        dc_register = token.at(2);
+    } else { // Otherwise it's either >, < or =
+        operation = token.substr(0, 1);
+        dc_register = token.at(1);
+    }
+
+    MacroOP op;
+    if(operation == ">") {
+        op = MacroOP::GT;
+    } else if(operation == "<") {
+        op = MacroOP::LT;
+    } else if(operation == "=") {
+        op = MacroOP::EQ;
+    } else if(operation == ">=") {
+        op = MacroOP::GEQ;
+    } else if(operation == "<=") {
+        op = MacroOP::LEQ;
+    } else if(operation == "!=") {
+        op = MacroOP::NEQ;
+    } else {
+        // Unknown comparisons do nothing
+        return;
+    }
+
+    program.code.push_back({OpCode::CMP, dc_register, static_cast<std::uint8_t>(op), 0});
+}
+
+/**
+ * @brief Compiles a DC register command
+ * @param program The program being compiled
+ * @param token The command followed by the register's name
+ */
+void Compiler::compile_register_command(Program &program, std::string_view token) {
+    OpCode opcode;
+    switch(token.at(0)) {
+        case 's': opcode = OpCode::STORE; break;
+        case 'S': opcode = OpCode::PUSH_REG; break;
+        case 'L': opcode = OpCode::POP_REG; break;
+        case 'l': opcode = OpCode::LOAD; break;
+        case 'c': opcode = OpCode::CLEAR_REG; break;
+        default: opcode = OpCode::REG_SIZE; break;
+    }
+
+    program.code.push_back({opcode, token.at(1), 0, 0});
+}
+
+/**
+ * @brief Compiles a DC array command
+ * @param program The program being compiled
+ * @param token The command followed by the array name
+ */
+void Compiler::compile_array_command(Program &program, std::string_view token) {
+    auto opcode = (token.at(0) == ':') ? OpCode::ARRAY_STORE : OpCode::ARRAY_LOAD;
+
+    program.code.push_back({opcode, token.at(1), 0, 0});
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+
+#include "adt.h"
+#include "value.h"
+#include "error.h"
+#include "lexer.h"
+
+/**
+ * @brief Instruction set of the DC virtual machine
+ */
+enum class OpCode : std::uint8_t {
+    OPERATION,      // Dispatch to the operation stored in the operand
+    PUSH,           // Push the literal stored in the operand
+    PUSH_MACRO,     // Push the macro stored in the operand
+    EXEC,           // Execute the head of the stack as a macro
+    CMP,            // Compare top two values and execute a register
+    STORE,          // sX
+    PUSH_REG,       // SX
+    POP_REG,        // LX
+    LOAD,           // lX
+    CLEAR_REG,      // cX
+    REG_SIZE,       // zX
+    ARRAY_STORE,    // :X
+    ARRAY_LOAD,     // ;X
+    QUIT,           // q
+    ERROR,          // Raise the error whose code is stored in the operand
+    // Superinstructions, see Compiler::optimize
+    DUP_MUL,        // d *
+    PUSH_ADD,       // <number> +
+    PUSH_SUB,       // <number> -
+    SWAP_SUB,       // r -
+    STORE_LOAD,     // sX lX
+    LOAD_EXEC,      // lX x
+    CMP_REGS,       // lA lB >C
+    FOLD            // Push the results of the folded sequence stored in the operand
+};
+
+/**
+ * @brief A single instruction of the DC virtual machine
+ *
+ * Each instruction carries its pre-decoded operands: the register name,
+ * the comparison kind and either an index into
+ * the literal pool or an operation type
+ */
+struct Instruction {
+    OpCode opcode;
+    char reg;
+    std::uint8_t aux;
+    std::uint32_t operand;
+};
+
+/**
+ * @brief A sequence of literals and pure operations evaluated at compile time
+ *
+ * The results are only valid for the precision the sequence has been folded with. Since
+ * operations update the last values(i.e., .x, .y, .z) according to the values below their
+ * operands, the effects on the last values are stored for each depth of the stack
+ */
+struct Fold {
+    /**
+     * @brief The effect of a folded sequence on a last value
+     */
+    struct LastValue {
+        enum class Source : std::uint8_t {
+            KEEP,       // The last value is not changed
+            CONSTANT,   // The last value is set to the value
+            STACK       // The last value is set to the element at the index, counting from the head
+        };
+
+        Source source;
+        std::size_t index;
+        dc::Value value;
+    };
+
+    // Operations see at most three values below their operands
+    static constexpr std::size_t MAX_DEPTH = 3;
+
+    Instruction original;
+    std::size_t length;
+    unsigned int precision;
+    std::pmr::vector<dc::Value> results;    // Allocated by the memory resource of the program
+    std::array<std::array<LastValue, 3>, MAX_DEPTH + 1> last_values;
+};
+
+class NativeCode;
+
+/**
+ * @brief A compiled DC program
+ *
+ * Made of a compact instruction array and a pool of literals referenced by the instructions.
+ * Literals are classified once, when the program is compiled. When the virtual machine enters the program
+ * with at least **prefix_depth** elements on the stack, the operands of the instructions of the prefix are not
+ * checked again. The tables of the program are allocated by a memory
+ * resource, so that the program of a line can live in the arena of the evaluation(see dc::Arena). Numeric macros
+ * can also be compiled into native code(see Jit)
+ */
+struct Program {
+    explicit Program(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : code(resource), literals(resource), folds(resource) {}
+
+    std::pmr::vector<Instruction> code;
+    std::pmr::vector<dc::Value> literals;
+    std::pmr::vector<Fold> folds;
+    std::size_t prefix_length = 0;
+    std::size_t prefix_depth = 0;       // Elements the prefix requires when the program is entered
+    std::shared_ptr<const NativeCode> native;
+};
+
+/**
+ * @brief Compiles DC source code into a program
+ *
+ * The source code is tokenized by the Lexer and tokens are classified once, at compile time. Errors that depend on the
+ * runtime state(e.g., the input radix) are left to the virtual machine, while the depth of the stack required by the
+ * straight-line prefix of the program, whose stack effect is known at compile time, is computed once. Sequences of literals and pure operations
+ * are folded according to the parameters the program is compiled with, while common sequences of instructions are
+ * fused into superinstructions by a peephole pass, which can be disabled for debugging.
+ *
+ * This class is **not** meant to be instantiated
+ */
+class Compiler {
+public:
+    Compiler() = delete;
+    static Program compile(std::string_view source, const dc::Parameters &parameters,
+                           std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    static Program compile(const dc::SharedString &source, const dc::Parameters &parameters,
+                           std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    static void set_peephole(bool enabled);
+    static Instruction unfuse(const Program &program, const Instruction &instr);
+
+    /**
+     * @brief Returns true if **opcode** is a superinstruction, false otherwise
+     * @param opcode The opcode to be checked
+     * @return Boolean value
+     */
+    static bool is_fused(OpCode opcode) { return opcode >= OpCode::DUP_MUL; }
+
+private:
+    static void analyze(Program &program);
+    static void fold(Program &program, const dc::Parameters &parameters);
+    static std::size_t fold_sequence(Program &program, std::size_t begin, const dc::Parameters &parameters);
+    static void optimize(Program &program);
+    static std::uint32_t add_literal(Program &program, dc::SharedString literal);
+    static bool compile_macro(Program &program, const dc::SharedString &source, const Token &token);
+    static void compile_macro_command(Program &program, std::string_view token);
+    static void compile_register_command(Program &program, std::string_view token);
+    static void compile_array_command(Program &program, std::string_view token);
+};
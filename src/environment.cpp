@@ -0,0 +1,237 @@
+#include <array>
+#include <memory>
+#include <cstdint>
+
+#include "environment.h"
+#include "mathematics.h"
+#include "statistics.h"
+#include "bitwise.h"
+#include "stack.h"
+#include "macro.h"
+
+namespace {
+    /**
+     * @brief Maps each DC command to its operation type
+     */
+    constexpr auto dc_commands = std::to_array<std::pair<std::string_view, OPType>>({
+        // Numerical operations
+        {"+", OPType::ADD}, {"-", OPType::SUB}, {"*", OPType::MUL}, {"/", OPType::DIV},
+        {"%", OPType::MOD}, {"~", OPType::DIV_MOD}, {"|", OPType::MOD_EXP}, {"^", OPType::EXP},
+        {"v", OPType::SQRT}, {"sin", OPType::SIN}, {"cos", OPType::COS}, {"tan", OPType::TAN},
+        {"asin", OPType::ASIN}, {"acos", OPType::ACOS}, {"atan", OPType::ATAN}, {"!", OPType::FACT},
+        {"pi", OPType::PI}, {"e", OPType::E}, {"@", OPType::RND}, {"$", OPType::INT},
+        {"b", OPType::TO_CMPLX}, {"re", OPType::GET_RE}, {"im", OPType::GET_IM}, {"y", OPType::LOG},
+        // Statistical operations
+        {"gP", OPType::PERM}, {"gC", OPType::COMB}, {"gs", OPType::SUMX}, {"gS", OPType::SUMXX},
+        {"gM", OPType::MEAN}, {"gD", OPType::SDEV}, {"gL", OPType::LREG},
+        // Bitwise operations
+        {"{", OPType::BAND}, {"}", OPType::BOR}, {"l", OPType::BNOT}, {"L", OPType::BXOR},
+        {"m", OPType::BSL}, {"M", OPType::BSR},
+        // Stack operations
+        {"p", OPType::PCG}, {"p.", OPType::PWS}, {"pb", OPType::PBB}, {"ph", OPType::PBH},
+        {"po", OPType::PBO}, {"P", OPType::P}, {"c", OPType::CLR}, {"R", OPType::PH},
+        {"r", OPType::SO}, {"d", OPType::DP}, {"f", OPType::PS}, {"Z", OPType::CH},
+        {"z", OPType::CS}, {"k", OPType::SP}, {"K", OPType::GP}, {"o", OPType::SOR},
+        {"O", OPType::GOR}, {"i", OPType::SIR}, {"I", OPType::GIR}, {".x", OPType::LX},
+        {".y", OPType::LY}, {".z", OPType::LZ}, {"w", OPType::FL},
+        // Macro operations
+        {"x", OPType::EX}, {"?", OPType::RI}, {"'", OPType::LF}
+    });
+
+    // Every command is at most four characters long, therefore
+    // it can be packed into a 32 bit integer without collisions
+    constexpr std::size_t MAX_TOKEN_LEN = Environment::MAX_COMMAND_LEN;
+    constexpr std::size_t TABLE_BITS = 10;
+    constexpr std::size_t TABLE_SIZE = (1 << TABLE_BITS);
+    constexpr std::size_t OPS_COUNT = static_cast<std::size_t>(OPType::LF) + 1;
+
+    struct Slot {
+        std::uint32_t key;
+        OPType op_type;
+    };
+
+    constexpr std::uint32_t pack(std::string_view token) {
+        std::uint32_t key = 0;
+        for(auto ch : token) {
+            key = (key << 8) | static_cast<unsigned char>(ch);
+        }
+
+        return key;
+    }
+
+    constexpr std::size_t hash(std::uint32_t key, std::uint32_t seed) {
+        return ((key ^ seed) * 0x9E3779B1u) >> (32 - TABLE_BITS);
+    }
+
+    /**
+     * @brief Searches for a seed that maps every command to a distinct slot
+     */
+    constexpr std::uint32_t find_seed() {
+        for(std::uint32_t seed = 1; seed != 0; seed++) {
+            std::array<bool, TABLE_SIZE> used{};
+            bool collision = false;
+
+            for(const auto& command : dc_commands) {
+                auto slot = hash(pack(command.first), seed);
+                if(used[slot]) {
+                    collision = true;
+                    break;
+                }
+                used[slot] = true;
+            }
+
+            if(!collision) {
+                return seed;
+            }
+        }
+
+        return 0;
+    }
+
+    constexpr std::uint32_t SEED = find_seed();
+    static_assert(SEED != 0, "Cannot build a perfect hash for the DC commands");
+
+    constexpr std::array<Slot, TABLE_SIZE> build_table() {
+        std::array<Slot, TABLE_SIZE> table{};
+        for(const auto& command : dc_commands) {
+            auto key = pack(command.first);
+            table[hash(key, SEED)] = Slot{key, command.second};
+        }
+
+        return table;
+    }
+
+    constexpr std::array<Slot, TABLE_SIZE> dispatch_table = build_table();
+
+    constexpr auto VAR = StackEffect::VARIABLE;
+
+    /**
+     * @brief Maps each operation type to its stack effect
+     */
+    constexpr auto dc_effects = std::to_array<std::pair<OPType, StackEffect>>({
+        // Numerical operations
+        {OPType::ADD, {2, 1, "'+' requires two operands"}}, {OPType::SUB, {2, 1, "'-' requires two operands"}},
+        {OPType::MUL, {2, 1, "'*' requires two operands"}}, {OPType::DIV, {2, 1, "'/' requires two operands"}},
+        {OPType::MOD, {2, 1, "'%' requires two operands"}}, {OPType::DIV_MOD, {2, VAR, "'~' requires two operands"}},
+        {OPType::MOD_EXP, {3, 1, "'|' requires three operands"}}, {OPType::EXP, {2, 1, "'^' requires two operands"}},
+        {OPType::SQRT, {1, 1, "'v' requires one operand"}}, {OPType::SIN, {1, 1, "'sin' requires one operand"}},
+        {OPType::COS, {1, 1, "'cos' requires one operand"}}, {OPType::TAN, {1, 1, "'tan' requires one operand"}},
+        {OPType::ASIN, {1, 1, "'asin' requires one operand"}}, {OPType::ACOS, {1, 1, "'acos' requires one operand"}},
+        {OPType::ATAN, {1, 1, "'atan' requires one operand"}}, {OPType::FACT, {1, 1, "'!' requires one operand"}},
+        {OPType::PI, {0, 1, ""}}, {OPType::E, {0, 1, ""}},
+        {OPType::RND, {2, 1, "'@' requires two operands"}}, {OPType::INT, {1, 1, "'$' requires one operand"}},
+        {OPType::TO_CMPLX, {2, 1, "'b' requires two values"}}, {OPType::GET_RE, {1, 1, "'re' requires one value"}},
+        {OPType::GET_IM, {1, 1, "'im' requires one value"}}, {OPType::LOG, {1, 1, "'y' requires one value"}},
+        // Statistical operations
+        {OPType::PERM, {2, 1, "'gP' requires two operands"}}, {OPType::COMB, {2, 1, "'gC' requires two operands"}},
+        {OPType::SUMX, {0, 1, ""}}, {OPType::SUMXX, {0, 1, ""}}, {OPType::MEAN, {0, 1, ""}},
+        {OPType::SDEV, {0, 1, ""}}, {OPType::LREG, {0, 2, ""}},
+        // Bitwise operations
+        {OPType::BAND, {2, 1, "'{' requires two operands"}}, {OPType::BOR, {2, 1, "'}' requires two operands"}},
+        {OPType::BNOT, {1, 1, "'l' requires one operand"}}, {OPType::BXOR, {2, 1, "'L' requires two operands"}},
+        {OPType::BSL, {2, 1, "'m' requires two operands"}}, {OPType::BSR, {2, 1, "'M' requires two operands"}},
+        // Stack operations. Printing does not remove the head of the stack
+        {OPType::PCG, {1, 1, "Cannot print empty stack"}}, {OPType::PWS, {1, 1, "Cannot print empty stack"}},
+        {OPType::P, {1, 1, "Cannot print empty stack"}}, {OPType::PBB, {1, 1, "Cannot print empty stack"}},
+        {OPType::PBH, {1, 1, "Cannot print empty stack"}}, {OPType::PBO, {1, 1, "Cannot print empty stack"}},
+        {OPType::CLR, {0, VAR, ""}}, {OPType::PH, {1, 0, "'R' does not work on empty stack"}},
+        {OPType::SO, {2, 2, "'r' requires two elements"}}, {OPType::DP, {1, 2, "'d' requires one element"}},
+        {OPType::PS, {0, 0, ""}}, {OPType::CH, {1, 1, "'Z' does not work on empty stack"}},
+        {OPType::CS, {0, 1, ""}}, {OPType::SP, {1, 0, "'k' requires one operand"}},
+        {OPType::GP, {0, 1, ""}}, {OPType::SOR, {1, 0, "'o' requires one operand"}},
+        {OPType::GOR, {0, 1, ""}}, {OPType::SIR, {1, 0, "'i' requires one operand"}},
+        {OPType::GIR, {0, 1, ""}}, {OPType::LX, {0, 1, ""}}, {OPType::LY, {0, 1, ""}}, {OPType::LZ, {0, 1, ""}},
+        {OPType::FL, {0, 0, ""}},
+        // Macro operations. Macros can do anything to the stack
+        {OPType::EX, {0, VAR, ""}}, {OPType::CMP, {0, VAR, ""}}, {OPType::RI, {0, VAR, ""}},
+        {OPType::LF, {1, VAR, "This operation does not work on empty stack"}}
+    });
+
+    constexpr std::array<StackEffect, OPS_COUNT> build_effects() {
+        std::array<StackEffect, OPS_COUNT> effects{};
+        for(const auto& effect : dc_effects) {
+            effects[static_cast<std::size_t>(effect.first)] = effect.second;
+        }
+
+        return effects;
+    }
+
+    static_assert(dc_effects.size() == OPS_COUNT, "Every operation must have a stack effect");
+    constexpr std::array<StackEffect, OPS_COUNT> effects_table = build_effects();
+
+    std::unique_ptr<IOperation> make_operation(OPType op_t) {
+        if(op_t <= OPType::LOG) {
+            return std::make_unique<Mathematics>(op_t);
+        } else if(op_t <= OPType::LREG) {
+            return std::make_unique<Statistics>(op_t);
+        } else if(op_t <= OPType::BSR) {
+            return std::make_unique<Bitwise>(op_t);
+        } else if(op_t <= OPType::FL) {
+            return std::make_unique<Stack>(op_t);
+        }
+
+        return std::make_unique<Macro>(op_t);
+    }
+}
+
+/**
+ * @brief Retrieves the operation type of a DC command
+ * @param token The DC command
+ * @return The operation type, if the command exists
+ */
+std::optional<OPType> Environment::find(std::string_view token) {
+    if(token.empty() || token.length() > MAX_TOKEN_LEN) {
+        return std::nullopt;
+    }
+
+    auto key = pack(token);
+    const auto& slot = dispatch_table[hash(key, SEED)];
+    if(slot.key != key) {
+        return std::nullopt;
+    }
+
+    return slot.op_type;
+}
+
+/**
+ * @brief Retrieves the operation that implements a DC command
+ * @param token The DC command
+ * @return A pointer to the operation or a null pointer if the command does not exist
+ */
+IOperation *Environment::lookup(std::string_view token) {
+    auto op_type = find(token);
+    if(op_type == std::nullopt) {
+        return nullptr;
+    }
+
+    return &operation(op_type.value());
+}
+
+/**
+ * @brief Retrieves the singleton instance of an operation
+ * @param op_t The operation type
+ * @return A reference to the operation
+ */
+IOperation &Environment::operation(OPType op_t) {
+    // Operations are stateless, therefore a single instance
+    // of each of them is allocated for the whole process
+    static const auto operations = [] {
+        std::array<std::unique_ptr<IOperation>, OPS_COUNT> ops;
+        for(const auto& command : dc_commands) {
+            ops[static_cast<std::size_t>(command.second)] = make_operation(command.second);
+        }
+
+        return ops;
+    }();
+
+    return *operations[static_cast<std::size_t>(op_t)];
+}
+
+/**
+ * @brief Retrieves the stack effect of an operation
+ * @param op_t The operation type
+ * @return The number of operands and results of the operation
+ */
+const StackEffect &Environment::stack_effect(OPType op_t) {
+    return effects_table[static_cast<std::size_t>(op_t)];
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <string_view>
+#include <cstddef>
+#include <optional>
+
+#include "operation.h"
+
+/**
+ * @brief The effect of an operation on the stack
+ *
+ * An operation requires its operands to be on the stack and, when it succeeds,
+ * replaces them with its results
+ */
+struct StackEffect {
+    static constexpr int VARIABLE = -1;
+
+    std::size_t operands;           // Number of elements taken from the stack
+    int results;                    // Number of elements pushed onto the stack, VARIABLE if unknown
+    std::string_view underflow;     // Error message of a stack with less than 'operands' elements
+};
+
+/**
+ * @brief Process-wide dispatch table of DC commands
+ *
+ * Maps each DC command to the operation that implements it. The lookup table is
+ * built at compile time through a perfect hash function while the operations are
+ * stateless singletons allocated once per process. Neither of them is ever modified
+ * after initialization, therefore the environment can be shared by every evaluator.
+ * The environment also holds the stack effect of each operation, which the virtual machine
+ * uses to check the operands before dispatching to the operation.
+ *
+ * This class is **not** meant to be instantiated
+ */
+class Environment {
+public:
+    Environment() = delete;
+    static constexpr std::size_t MAX_COMMAND_LEN = 4;
+    static std::optional<OPType> find(std::string_view token);
+    static IOperation *lookup(std::string_view token);
+    static IOperation &operation(OPType op_t);
+    static const StackEffect &stack_effect(OPType op_t);
+};
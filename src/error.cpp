@@ -0,0 +1,53 @@
+#include "error.h"
+
+namespace dc {
+    /**
+     * @brief Renders the message of the error
+     * @return The message to be reported to the user
+     */
+    std::string Error::message() const {
+        auto op = std::string(this->detail.view());
+        auto reg_name = std::string(1, this->reg);
+
+        switch(this->code) {
+            case ErrorCode::UNDERFLOW: return op;
+            case ErrorCode::EMPTY_STACK: return "This operation does not work on empty stack";
+            case ErrorCode::REQUIRES_ONE_VALUE: return "This operation requires one value";
+            case ErrorCode::REQUIRES_TWO_VALUES: return "This operation requires two values";
+            case ErrorCode::REQUIRES_TWO_ELEMENTS: return "This operation requires two elements";
+            case ErrorCode::NUMERIC_OPERANDS: return "'" + op + "' requires numeric values";
+            case ErrorCode::COMPLEX_OPERANDS: return "'" + op + "' requires complex values";
+            case ErrorCode::INTEGER_OPERANDS: return "'" + op + "' requires integer values";
+            case ErrorCode::POSITIVE_INTEGERS: return "'" + op + "' requires positive integers";
+            case ErrorCode::STRING_OPERANDS: return "This operation requires string values";
+            case ErrorCode::DIVISION_BY_ZERO: return "Cannot divide by zero";
+            case ErrorCode::ZERO_MODULUS: return "Modulus cannot be zero";
+            case ErrorCode::NEGATIVE_EXPONENT: return "Exponent cannot be negative";
+            case ErrorCode::NEGATIVE_FACTORIAL: return "'!' is not defined for negative numbers";
+            case ErrorCode::INTEGER_OUTPUT: return "This output radix requires integer values";
+            case ErrorCode::UNSUPPORTED_OUTPUT_BASE: return "Unsupported output base";
+            case ErrorCode::INVALID_PRECISION: return "Precision must be a non-negative number";
+            case ErrorCode::NUMERIC_OUTPUT_RADIX: return "'o' requires numeric values only";
+            case ErrorCode::INVALID_OUTPUT_RADIX: return "'o' accepts either BIN, OCT, DEC or HEX bases";
+            case ErrorCode::INVALID_INPUT_RADIX: return "Input base must be a number within the range 2-16(inclusive)";
+            case ErrorCode::INTEGER_INPUT: return "This input base supports integers only";
+            case ErrorCode::INVALID_NUMBER: return "Invalid number for input base '" + std::to_string(this->index) + "'";
+            case ErrorCode::UNRECOGNIZED_OPTION: return "Unrecognized option";
+            case ErrorCode::UNMANAGED: return "Unmanaged error";
+            case ErrorCode::UNDEFINED_REGISTER: return "Register '" + reg_name + "' is undefined";
+            case ErrorCode::EMPTY_REGISTER: return "The stack of register '" + reg_name + "' is empty";
+            case ErrorCode::EMPTY_ARRAY: return "The array of register '" + reg_name + "' is empty";
+            case ErrorCode::INVALID_ARRAY_INDEX: return "Array index must be an integer";
+            case ErrorCode::ARRAY_OUT_OF_BOUNDS: return "Cannot access " + reg_name + "[" + std::to_string(this->index) + "]";
+            case ErrorCode::REGISTER_LENGTH_MISMATCH: return "'X' and 'Y' registers must be of the same length";
+            case ErrorCode::NULL_REGISTER: return "Null register";
+            case ErrorCode::STDIN_ERROR: return "Error while reading from stdin";
+            case ErrorCode::CANNOT_OPEN_FILE: return "Cannot open source file \"" + op + "\"";
+            case ErrorCode::UNBALANCED_PARENTHESIS: return "Unbalanced parenthesis";
+            case ErrorCode::EMPTY_MACRO: return "Empty macro";
+            case ErrorCode::QUIT: return "";
+        }
+
+        return "Unmanaged error";
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+#include "shared_string.h"
+
+namespace dc {
+    /**
+     * @brief Kinds of errors raised by the DC virtual machine and by its operations
+     */
+    enum class ErrorCode : std::uint8_t {
+        UNDERFLOW,              // Stack underflow, the message is the detail
+        EMPTY_STACK,
+        REQUIRES_ONE_VALUE,
+        REQUIRES_TWO_VALUES,
+        REQUIRES_TWO_ELEMENTS,
+        NUMERIC_OPERANDS,       // The detail is the operation
+        COMPLEX_OPERANDS,       // The detail is the operation
+        INTEGER_OPERANDS,       // The detail is the operation
+        POSITIVE_INTEGERS,      // The detail is the operation
+        STRING_OPERANDS,
+        DIVISION_BY_ZERO,
+        ZERO_MODULUS,
+        NEGATIVE_EXPONENT,
+        NEGATIVE_FACTORIAL,
+        INTEGER_OUTPUT,
+        UNSUPPORTED_OUTPUT_BASE,
+        INVALID_PRECISION,
+        NUMERIC_OUTPUT_RADIX,
+        INVALID_OUTPUT_RADIX,
+        INVALID_INPUT_RADIX,
+        INTEGER_INPUT,
+        INVALID_NUMBER,         // The index is the input radix
+        UNRECOGNIZED_OPTION,
+        UNMANAGED,
+        UNDEFINED_REGISTER,     // Uses the register
+        EMPTY_REGISTER,         // Uses the register
+        EMPTY_ARRAY,            // Uses the register
+        INVALID_ARRAY_INDEX,
+        ARRAY_OUT_OF_BOUNDS,    // Uses the register and the index
+        REGISTER_LENGTH_MISMATCH,
+        NULL_REGISTER,
+        STDIN_ERROR,
+        CANNOT_OPEN_FILE,       // The detail is the file name
+        UNBALANCED_PARENTHESIS,
+        EMPTY_MACRO,
+        QUIT                    // Not an error: 'q' stops the evaluation
+    };
+
+    /**
+     * @brief An error of the DC virtual machine
+     *
+     * Errors are made of a code and of a small payload: a register, an index and a detail, which is
+     * either a string with static storage(e.g., the name of an operation) or a shared string. Raising
+     * an error does not allocate, since its message is rendered only when it is reported to the user.
+     */
+    class Error {
+    public:
+        explicit Error(ErrorCode c) : code(c) {}
+        Error(ErrorCode c, std::string_view literal) : code(c), detail(SharedString::from_literal(literal)) {}
+        Error(ErrorCode c, SharedString text) : code(c), detail(std::move(text)) {}
+        Error(ErrorCode c, char r, std::int64_t idx = 0) : code(c), reg(r), index(idx) {}
+
+        [[nodiscard]] ErrorCode get_code() const { return this->code; }
+        [[nodiscard]] bool is_quit() const { return this->code == ErrorCode::QUIT; }
+        [[nodiscard]] std::string message() const;
+
+    private:
+        ErrorCode code;
+        char reg = '\0';
+        std::int64_t index = 0;
+        SharedString detail;
+    };
+}
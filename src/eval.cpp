@@ -1,333 +1,514 @@
-#include <memory>
+#include <algorithm>
+#include <cmath>
 
 #include "adt.cpp"
 #include "eval.h"
-#include "mathematics.h"
-#include "statistics.h"
-#include "bitwise.h"
-#include "stack.h"
+#include "environment.h"
 #include "macro.h"
+#include "macro_cache.h"
+#include "jit.h"
 #include "num_utils.h"
 
-#define MACRO_COND(VAL) ((VAL.length() == 1 && VAL == "["))
-#define MACRO_CMD_COND(VAL) ((VAL.length() == 2 || VAL.length() == 3) && \
-              (VAL.at(0) == '>' || VAL.at(0) == '<' || \
-               VAL.at(0) == '=' || VAL.at(0) == '!'))
-#define REGISTER_COND(VAL) ((VAL.length() == 2) && \
-              (VAL.at(0) == 's' || VAL.at(0) == 'S' || \
-               VAL.at(0) == 'l' || VAL.at(0) == 'L' || \
-               VAL.at(0) == 'c' || VAL.at(0) == 'z'))
-#define ARRAY_COND(VAL) ((VAL.length() == 2) && \
-        (VAL.at(0) == ':' || VAL.at(0) == ';'))
-
 #define X_CONTAINS_Y(X, Y) ((Y.find_first_of(X) != std::string::npos))
-#define MAKE_UNIQUE_PTR(CLASS, ARG) [](){ return std::make_unique<CLASS>(ARG); }
+
+static bool threaded_dispatch = true;
 
 /**
- * @brief Initializes the DC environment
- * 
- * Maps each operation to the appropriate function
+ * @brief Selects how the virtual machine dispatches instructions
+ *
+ * Threaded dispatch is only available when the virtual machine has been built
+ * with computed goto(see the DC_COMPUTED_GOTO option), otherwise instructions are
+ * always dispatched by a switch
+ *
+ * @param enabled Whether each handler jumps straight to the handler of the next instruction
  */
-void Evaluate::init_environment() {
-    // Numerical operations
-    this->op_factory.emplace("+", MAKE_UNIQUE_PTR(Mathematics, OPType::ADD));
-    this->op_factory.emplace("-", MAKE_UNIQUE_PTR(Mathematics, OPType::SUB));
-    this->op_factory.emplace("*", MAKE_UNIQUE_PTR(Mathematics, OPType::MUL));
-    this->op_factory.emplace("/", MAKE_UNIQUE_PTR(Mathematics, OPType::DIV));
-    this->op_factory.emplace("%", MAKE_UNIQUE_PTR(Mathematics, OPType::MOD));
-    this->op_factory.emplace("~", MAKE_UNIQUE_PTR(Mathematics, OPType::DIV_MOD));
-    this->op_factory.emplace("|", MAKE_UNIQUE_PTR(Mathematics, OPType::MOD_EXP));
-    this->op_factory.emplace("^", MAKE_UNIQUE_PTR(Mathematics, OPType::EXP));
-    this->op_factory.emplace("v", MAKE_UNIQUE_PTR(Mathematics, OPType::SQRT));
-    this->op_factory.emplace("sin", MAKE_UNIQUE_PTR(Mathematics, OPType::SIN));
-    this->op_factory.emplace("cos", MAKE_UNIQUE_PTR(Mathematics, OPType::COS));
-    this->op_factory.emplace("tan", MAKE_UNIQUE_PTR(Mathematics, OPType::TAN));
-    this->op_factory.emplace("asin", MAKE_UNIQUE_PTR(Mathematics, OPType::ASIN));
-    this->op_factory.emplace("acos", MAKE_UNIQUE_PTR(Mathematics, OPType::ACOS));
-    this->op_factory.emplace("atan", MAKE_UNIQUE_PTR(Mathematics, OPType::ATAN));
-    this->op_factory.emplace("!", MAKE_UNIQUE_PTR(Mathematics, OPType::FACT));
-    this->op_factory.emplace("pi", MAKE_UNIQUE_PTR(Mathematics, OPType::PI));
-    this->op_factory.emplace("e", MAKE_UNIQUE_PTR(Mathematics, OPType::E));
-    this->op_factory.emplace("@", MAKE_UNIQUE_PTR(Mathematics, OPType::RND));
-    this->op_factory.emplace("$", MAKE_UNIQUE_PTR(Mathematics, OPType::INT));
-    this->op_factory.emplace("b", MAKE_UNIQUE_PTR(Mathematics, OPType::TO_CMPLX));
-    this->op_factory.emplace("re", MAKE_UNIQUE_PTR(Mathematics, OPType::GET_RE));
-    this->op_factory.emplace("im", MAKE_UNIQUE_PTR(Mathematics, OPType::GET_IM));
-    this->op_factory.emplace("y", MAKE_UNIQUE_PTR(Mathematics, OPType::LOG));
-    // Statistical operations
-    this->op_factory.emplace("gP", MAKE_UNIQUE_PTR(Statistics, OPType::PERM));
-    this->op_factory.emplace("gC", MAKE_UNIQUE_PTR(Statistics, OPType::COMB));
-    this->op_factory.emplace("gs", MAKE_UNIQUE_PTR(Statistics, OPType::SUMX));
-    this->op_factory.emplace("gS", MAKE_UNIQUE_PTR(Statistics, OPType::SUMXX));
-    this->op_factory.emplace("gM", MAKE_UNIQUE_PTR(Statistics, OPType::MEAN));
-    this->op_factory.emplace("gD", MAKE_UNIQUE_PTR(Statistics, OPType::SDEV));
-    this->op_factory.emplace("gL", MAKE_UNIQUE_PTR(Statistics, OPType::LREG));
-    // Bitwise operations
-    this->op_factory.emplace("{", MAKE_UNIQUE_PTR(Bitwise, OPType::BAND));
-    this->op_factory.emplace("}", MAKE_UNIQUE_PTR(Bitwise, OPType::BOR));
-    this->op_factory.emplace("l", MAKE_UNIQUE_PTR(Bitwise, OPType::BNOT));
-    this->op_factory.emplace("L", MAKE_UNIQUE_PTR(Bitwise, OPType::BXOR));
-    this->op_factory.emplace("m", MAKE_UNIQUE_PTR(Bitwise, OPType::BSL));
-    this->op_factory.emplace("M", MAKE_UNIQUE_PTR(Bitwise, OPType::BSR));
-    // Stack operations
-    this->op_factory.emplace("p", MAKE_UNIQUE_PTR(Stack, OPType::PCG));
-    this->op_factory.emplace("p.", MAKE_UNIQUE_PTR(Stack, OPType::PWS));
-    this->op_factory.emplace("pb", MAKE_UNIQUE_PTR(Stack, OPType::PBB));
-    this->op_factory.emplace("ph", MAKE_UNIQUE_PTR(Stack, OPType::PBH));
-    this->op_factory.emplace("po", MAKE_UNIQUE_PTR(Stack, OPType::PBO));
-    this->op_factory.emplace("P", MAKE_UNIQUE_PTR(Stack, OPType::P));
-    this->op_factory.emplace("c", MAKE_UNIQUE_PTR(Stack, OPType::CLR));
-    this->op_factory.emplace("R", MAKE_UNIQUE_PTR(Stack, OPType::PH));
-    this->op_factory.emplace("r", MAKE_UNIQUE_PTR(Stack, OPType::SO));
-    this->op_factory.emplace("d", MAKE_UNIQUE_PTR(Stack, OPType::DP));
-    this->op_factory.emplace("f", MAKE_UNIQUE_PTR(Stack, OPType::PS));
-    this->op_factory.emplace("Z", MAKE_UNIQUE_PTR(Stack, OPType::CH));
-    this->op_factory.emplace("z", MAKE_UNIQUE_PTR(Stack, OPType::CS));
-    this->op_factory.emplace("k", MAKE_UNIQUE_PTR(Stack, OPType::SP));
-    this->op_factory.emplace("K", MAKE_UNIQUE_PTR(Stack, OPType::GP));
-    this->op_factory.emplace("o", MAKE_UNIQUE_PTR(Stack, OPType::SOR));
-    this->op_factory.emplace("O", MAKE_UNIQUE_PTR(Stack, OPType::GOR));
-    this->op_factory.emplace("i", MAKE_UNIQUE_PTR(Stack, OPType::SIR));
-    this->op_factory.emplace("I", MAKE_UNIQUE_PTR(Stack, OPType::GIR));
-    this->op_factory.emplace(".x", MAKE_UNIQUE_PTR(Stack, OPType::LX));
-    this->op_factory.emplace(".y", MAKE_UNIQUE_PTR(Stack, OPType::LY));
-    this->op_factory.emplace(".z", MAKE_UNIQUE_PTR(Stack, OPType::LZ));
-    // Macro operations
-    this->op_factory.emplace("x", MAKE_UNIQUE_PTR(Macro, OPType::EX));
-    this->op_factory.emplace("?", MAKE_UNIQUE_PTR(Macro, OPType::RI));
-    this->op_factory.emplace("'", MAKE_UNIQUE_PTR(Macro, OPType::LF));
+void Evaluate::set_threaded(bool enabled) {
+    threaded_dispatch = enabled;
 }
 
 /**
  * @brief Evaluates the source code of a DC program
- * @return Errors of evaluation, if any.
+ *
+ * Macro calls do not recurse into a new evaluator: each call pushes a frame onto
+ * an explicit frame stack, while a call in tail position replaces the current frame.
+ * Loops, which in DC are tail recursive macros, therefore run in constant native
+ * stack and memory.
+ *
+ * When the stack is deep enough for the prefix of a program(see Compiler::analyze) as the
+ * program is entered, the operations of the prefix are dispatched without further checks.
+ *
+ * @return Errors of evaluation, if any. 'q' stops the evaluation with dc::ErrorCode::QUIT,
+ * the caller decides whether to exit
  */
-std::optional<std::string> Evaluate::eval() {
-    // Set up environment
-    init_environment();
-
-    for(std::size_t idx = 0; idx < this->expr.size(); idx++) {
-        std::optional<std::string> err = std::nullopt;
-        auto token = this->expr.at(idx);
-
-        // If token exists in the environment, instantiate it through the factory
-        if (this->op_factory.find(token) != this->op_factory.end()) {
-            std::unique_ptr<IOperation> operation = this->op_factory[token]();
-            err = operation->exec(this->stack, this->parameters, this->regs);
-        } else if(token == "q") {
-            std::exit(0);
-        } else if(MACRO_COND(token)) {
-            err = parse_macro(idx);
-        } else if(MACRO_CMD_COND(token)) {
-            err = parse_macro_command(token);
-        } else if(REGISTER_COND(token)) {
-            err = parse_register_command(token);
-        } else if(ARRAY_COND(token)) {
-            err = parse_array_command(token);
-        } else if(this->parameters.iradix != 10) {
-            err = parse_base_n(token);
-        } else if(NumericUtils::is_numeric<double>(token)) {
-            this->stack.push(token);
-        } else {
-            return "Unrecognized option";
-        }
+std::optional<dc::Error> Evaluate::eval() {
+    std::pmr::vector<Frame> frames(this->resource);
+    frames.push_back(Frame{this->program, 0, checked_prefix(*this->program)});
 
-        if(err != std::nullopt) {
-            return err;
-        }
+#ifdef DC_COMPUTED_GOTO
+    if(threaded_dispatch) {
+        return run<true>(frames);
     }
+#endif
 
-    return std::nullopt;
+    return run<false>(frames);
 }
 
+// Labels as values are a GNU extension
+#ifdef DC_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#define VM_DISPATCH() do {                                                      \
+        if constexpr(threaded) {                                                \
+            goto *handlers[static_cast<std::size_t>(instr.opcode)];             \
+        } else {                                                                \
+            goto dispatch;                                                      \
+        }                                                                       \
+    } while(0)
+#else
+#define VM_DISPATCH() goto dispatch
+#endif
+
+// Fetches the next instruction of the current frame and jumps to its handler
+#define VM_NEXT() do {                                                          \
+        if(frame->pc == frame->program->code.size()) {                          \
+            goto ret;                                                           \
+        }                                                                       \
+        instr = frame->program->code[frame->pc++];                              \
+        VM_DISPATCH();                                                          \
+    } while(0)
+
+// Returns the error of an instruction, if any
+#define VM_CHECK(EXPR) do {                                                     \
+        if(auto vm_err = (EXPR)) {                                              \
+            return vm_err;                                                      \
+        }                                                                       \
+    } while(0)
+
 /**
- * @brief Parses numbers in a non decimal numeric system
- * @param token The value to be parsed in the chosen base
- * @return Parsing errors, if any
+ * @brief Executes the frames of the virtual machine
+ *
+ * Each instruction has its own handler. With threaded dispatch, every handler fetches
+ * the next instruction and jumps straight to its handler through a table of labels,
+ * so that each handler has its own indirect branch. Otherwise handlers jump back to a
+ * single switch. Both strategies share the same handlers
+ *
+ * @param frames The frame stack of the virtual machine, holding the program to be executed
+ *
+ * @return Errors of evaluation, if any.
  */
-std::optional<std::string> Evaluate::parse_base_n(const std::string& token) {
-    // Discard values that are neither integers neither within "ABCDEF"
-    if(!NumericUtils::is_numeric<long>(token) && !X_CONTAINS_Y("ABCDEF", token)) {
-        return "This input base supports integers only";
+template<bool threaded>
+std::optional<dc::Error> Evaluate::run(std::pmr::vector<Frame> &frames) {
+#ifdef DC_COMPUTED_GOTO
+    // Indexed by OpCode
+    static const void *const handlers[] = {
+        &&op_operation, &&op_push, &&op_push_macro, &&op_exec, &&op_cmp,
+        &&op_register, &&op_register, &&op_register, &&op_register, &&op_register, &&op_register,
+        &&op_array, &&op_array, &&op_quit, &&op_error,
+        &&op_fused, &&op_fused, &&op_fused, &&op_fused, &&op_fused, &&op_fused, &&op_fused, &&op_fused
+    };
+    static_assert(std::size(handlers) == static_cast<std::size_t>(OpCode::FOLD) + 1);
+#endif
+
+    auto *frame = &frames.back();
+    Instruction instr{};
+    dc::SharedString dc_macro;
+
+    VM_NEXT();
+
+    // Threaded dispatch does not use the switch
+#ifdef DC_COMPUTED_GOTO
+dispatch: __attribute__((unused));
+#else
+dispatch:
+#endif
+    switch(instr.opcode) {
+        case OpCode::OPERATION: goto op_operation;
+        case OpCode::PUSH: goto op_push;
+        case OpCode::PUSH_MACRO: goto op_push_macro;
+        case OpCode::EXEC: goto op_exec;
+        case OpCode::CMP: goto op_cmp;
+        case OpCode::STORE:
+        case OpCode::PUSH_REG:
+        case OpCode::POP_REG:
+        case OpCode::LOAD:
+        case OpCode::CLEAR_REG:
+        case OpCode::REG_SIZE: goto op_register;
+        case OpCode::ARRAY_STORE:
+        case OpCode::ARRAY_LOAD: goto op_array;
+        case OpCode::QUIT: goto op_quit;
+        case OpCode::ERROR: goto op_error;
+        case OpCode::DUP_MUL:
+        case OpCode::PUSH_ADD:
+        case OpCode::PUSH_SUB:
+        case OpCode::SWAP_SUB:
+        case OpCode::STORE_LOAD:
+        case OpCode::LOAD_EXEC:
+        case OpCode::CMP_REGS:
+        case OpCode::FOLD: goto op_fused;
     }
 
-    // Try to convert the number to the selected numeric base
-    try {
-        long number = std::stol(token, nullptr, this->parameters.iradix);
-        this->stack.push(std::to_string(number));
-    } catch(...) {
-        return "Invalid number for input base '" 
-            + std::to_string(this->parameters.iradix) + "'"; 
+op_operation: {
+        auto op_type = static_cast<OPType>(instr.operand);
+        const auto &effect = Environment::stack_effect(op_type);
+        if(frame->pc > frame->checked && this->stack.size() < effect.operands) {
+            return dc::Error(dc::ErrorCode::UNDERFLOW, effect.underflow);
+        }
+
+        VM_CHECK(Environment::operation(op_type).exec(this->stack, this->parameters, this->regs));
+        VM_NEXT();
+    }
+op_push:
+    VM_CHECK(push_literal(frame->program->literals[instr.operand]));
+    VM_NEXT();
+op_push_macro:
+    this->stack.push(frame->program->literals[instr.operand]);
+    VM_NEXT();
+op_exec:
+    VM_CHECK(Macro::fetch_macro(this->stack, dc_macro));
+    goto schedule;
+op_cmp:
+    VM_CHECK(Macro::fetch_comparison(static_cast<MacroOP>(instr.aux), instr.reg,
+                                     this->stack, this->regs, dc_macro));
+    goto schedule;
+op_register:
+    VM_CHECK(register_command(instr.opcode, instr.reg));
+    VM_NEXT();
+op_array:
+    VM_CHECK(array_command(instr.opcode, instr.reg));
+    VM_NEXT();
+op_quit:
+    return dc::Error(dc::ErrorCode::QUIT);
+op_error:
+    return dc::Error(static_cast<dc::ErrorCode>(instr.operand));
+op_fused:
+    // Superinstructions either skip the instructions they replace
+    // or fall back to the first of them
+    if(auto length = exec_fused(instr, *frame->program, dc_macro); length != 0) {
+        frame->pc += length - 1;
+        goto schedule;
     }
+    instr = Compiler::unfuse(*frame->program, instr);
+    VM_DISPATCH();
+
+schedule:
+    // Schedule the macro, if any
+    if(!dc_macro.empty()) {
+        call(frames, dc_macro);
+        dc_macro = dc::SharedString();
+        frame = &frames.back();
+    }
+    VM_NEXT();
 
-    return std::nullopt;
+ret:
+    // Return from the current macro
+    frames.pop_back();
+    if(frames.empty()) {
+        return std::nullopt;
+    }
+    frame = &frames.back();
+    VM_NEXT();
 }
 
+#undef VM_CHECK
+#undef VM_NEXT
+#undef VM_DISPATCH
+#ifdef DC_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
 /**
- * @brief Parses a DC macro
- * @param idx The position of the current token to be parsed
- * @return Syntax errors, if any
+ * @brief Schedules the execution of a macro
+ *
+ * If the call is in tail position(i.e., it is the last instruction of the
+ * current frame), the current frame is discarded before pushing the new one.
+ * Macros compiled into native code are executed right away, without a frame,
+ * unless they deoptimise(see Jit::run)
+ *
+ * @param frames The frame stack of the virtual machine
+ * @param dc_macro The source code of the macro
  */
-std::optional<std::string> Evaluate::parse_macro(std::size_t &idx) {
-    // A macro is any string surrounded by square brackets
-    std::string dc_macro;
-    std::int8_t brackets_count = 1;
-
-    // Scan next token
-    idx++;
-
-    // Parse the macro
-    while(idx < this->expr.size()) {
-        // Parse nested macros as well
-        if(this->expr.at(idx) == "[") {
-            brackets_count++;
-        } else if(this->expr.at(idx) == "]") {
-            brackets_count--;
-            if(brackets_count == 0) {
-                break;
+void Evaluate::call(std::pmr::vector<Frame> &frames, const dc::SharedString &dc_macro) {
+    auto body = dc_macro;
+    while(true) {
+        auto callee = MacroCache::instance().get(body, this->parameters);
+
+        if(callee->native != nullptr) {
+            dc::SharedString next;
+            auto status = Jit::run(*callee->native, *callee, body, this->stack, this->regs, this->parameters, next);
+            if(status == JitStatus::RETURN) {
+                return;
+            }
+            if(status == JitStatus::CALL) {
+                // The macro called by a native macro is in tail position
+                body = std::move(next);
+                continue;
             }
         }
 
-        // Otherwise append the token to the macro.
-        // If the macro is not empty, add some spacing
-        // before the new token
-        if(dc_macro.empty()) {
-            dc_macro += this->expr.at(idx);
+        auto checked = checked_prefix(*callee);
+        if(frames.back().pc == frames.back().program->code.size()) {
+            frames.back() = Frame{std::move(callee), 0, checked};
         } else {
-            dc_macro += ' ' + this->expr.at(idx);
+            frames.push_back(Frame{std::move(callee), 0, checked});
         }
 
-        // Go to the next token
-        idx++;
-    }
-
-    // Check if macro is properly formatted
-    if(brackets_count != 0) {
-        return "Unbalanced parenthesis";
+        return;
     }
+}
 
-    // Check if macro is empty
-    if(dc_macro.empty()) {
-        return "Empty macro";
-    }
+/**
+ * @brief Checks the operands of the prefix of a program that is being entered
+ * @param prog The program
+ * @return The length of the prefix if the stack is deep enough for it, zero otherwise
+ */
+std::size_t Evaluate::checked_prefix(const Program &prog) {
+    return (this->stack.size() >= prog.prefix_depth) ? prog.prefix_length : 0;
+}
 
-    // Push the macro back onto the stack
-    this->stack.push(dc_macro);
+/**
+ * @brief Subtracts two numbers like the '-' command does
+ *
+ * Results close to zero are flushed to zero, to prevent -0/+0 results
+ */
+static double difference(double lhs, double rhs) {
+    auto result = lhs - rhs;
 
-    return std::nullopt;
+    return (std::abs(result) < 1e-10) ? 0.0 : result;
 }
 
 /**
- * @brief Parses a DC macro command and execute it
- * 
- * This method parses a macro command, then it pops two values from the stack.
- * If the top-of-stack is greater(or less, equal, etc.), execute register;s content
- * as a macro.
- * @param token The comparison symbol
- * @return Evaluation errors, if any
+ * @brief Executes the fast path of a superinstruction
+ *
+ * The fast path has the same effects of the instructions it replaces, last
+ * values(i.e., .x, .y, .z) included. It only applies when the instructions would
+ * succeed on numbers; anything else(e.g., strings, complex numbers or errors) is
+ * left to the original instructions
+ *
+ * @param instr The superinstruction
+ * @param prog The program the superinstruction belongs to
+ * @param dc_macro The macro to be executed, if any
+ *
+ * @return The number of instructions that have been executed, 0 if the fast path does not apply
  */
-std::optional<std::string> Evaluate::parse_macro_command(std::string token) {
-    // A macro command is a comparison symbol(>, <, =, >=, <=, !=)
-    // followed by a register name(e.g, >A)
-    // If command has length equal to three, then it's either '<=', '>=' or '!='
-
-    // Check if command is >=, <= or !=
-    std::string operation;
-    char dc_register = 0;
-    if(token.length() == 3) {
-        operation = token.substr(0, 2);
-        dc_register = token.at(2);
-    } else { // Otherwise it's either >, < or =
-        operation = token.at(0);
-        dc_register = token.at(1);
-    }
+std::size_t Evaluate::exec_fused(const Instruction &instr, const Program &prog, dc::SharedString &dc_macro) {
+    auto len = this->stack.size();
+    auto precision = this->parameters.precision;
+
+    switch(instr.opcode) {
+        case OpCode::DUP_MUL: {
+            if(len == 0 || !this->stack[len-1].is_number()) {
+                return 0;
+            }
+
+            this->stack.push(this->stack[len-1]);
+            this->stack.copy_xyz();
+            auto x = this->stack.pop(true).to_double();
+            this->stack.set(len-1, dc::Value(x * x, precision));
 
-    // Macro commands works as follows
-    // Pop two values off the stack and compares them assuming
-    // they are numbers. If top-of-stack is greater(or less, equal, etc.),
-    // execute register's content as a macro
-    std::optional<std::string> err = std::nullopt;
-    if(operation == ">") {
-        auto macro = std::make_unique<Macro>(OPType::CMP, MacroOP::GT, dc_register);
-        err = macro->exec(this->stack, this->parameters, this->regs);
-        if(err != std::nullopt) {
-            return err;
+            return 2;
         }
-    } else if(operation == "<") {
-        auto macro = std::make_unique<Macro>(OPType::CMP, MacroOP::LT, dc_register);
-        err = macro->exec(this->stack, this->parameters, this->regs);
-        if(err != std::nullopt) {
-            return err;
+        case OpCode::PUSH_ADD:
+        case OpCode::PUSH_SUB: {
+            // Literals of superinstructions are decimal numbers
+            if(this->parameters.iradix != 10 || len == 0 || !this->stack[len-1].is_number()) {
+                return 0;
+            }
+
+            const auto &literal = prog.literals[instr.operand];
+            this->stack.push(literal);
+            this->stack.copy_xyz();
+            this->stack.drop();
+
+            auto lhs = this->stack[len-1].to_double();
+            auto rhs = literal.to_double();
+            auto result = (instr.opcode == OpCode::PUSH_ADD) ? (lhs + rhs) : difference(lhs, rhs);
+            this->stack.set(len-1, dc::Value(result, precision));
+
+            return 2;
         }
-    } else if(operation == "=") {
-        auto macro = std::make_unique<Macro>(OPType::CMP, MacroOP::EQ, dc_register);
-        err = macro->exec(this->stack, this->parameters, this->regs);
-        if(err != std::nullopt) {
-            return err;
+        case OpCode::SWAP_SUB: {
+            if(len < 2 || !this->stack[len-1].is_number() || !this->stack[len-2].is_number()) {
+                return 0;
+            }
+
+            // The subtraction overwrites the last values set by the swap
+            this->stack.swap(len-1, len-2);
+            this->stack.copy_xyz();
+            auto rhs = this->stack.pop(true).to_double();
+            auto lhs = this->stack[len-2].to_double();
+            this->stack.set(len-2, dc::Value(difference(lhs, rhs), precision));
+
+            return 2;
         }
-    } else if(operation == ">=") {
-        auto macro = std::make_unique<Macro>(OPType::CMP, MacroOP::GEQ, dc_register);
-        err = macro->exec(this->stack, this->parameters, this->regs);
-        if(err != std::nullopt) {
-            return err;
+        case OpCode::STORE_LOAD: {
+            if(len == 0) {
+                return 0;
+            }
+
+            // Loading the register pushes back the value that has just been stored
+            this->stack.copy_xyz();
+            auto &reg_stack = this->regs[instr.reg].stack;
+            if(reg_stack.empty()) {
+                reg_stack.push(this->stack[len-1]);
+            } else {
+                reg_stack.set(reg_stack.size()-1, this->stack[len-1]);
+            }
+
+            return 2;
         }
-    } else if(operation == "<=") {
-        auto macro = std::make_unique<Macro>(OPType::CMP, MacroOP::LEQ, dc_register);
-        err = macro->exec(this->stack, this->parameters, this->regs);
-        if(err != std::nullopt) {
-            return err;
+        case OpCode::LOAD_EXEC: {
+            this->stack.push(peek_register(instr.reg));
+
+            // Numbers are left onto the stack
+            if(!this->stack[len].is_number()) {
+                this->stack.copy_xyz();
+                dc_macro = this->stack.pop(true).to_shared_string();
+            }
+
+            return 2;
         }
-    } else if(operation == "!=") {
-        auto macro = std::make_unique<Macro>(OPType::CMP, MacroOP::NEQ, dc_register);
-        err = macro->exec(this->stack, this->parameters, this->regs);
-        if(err != std::nullopt) {
-            return err;
+        case OpCode::CMP_REGS: {
+            // A missing register is an error, which is left to the original instructions
+            auto cmp_reg = static_cast<char>(instr.operand & 0xFF);
+            auto *reg = this->regs.find(cmp_reg);
+            if(reg == nullptr || reg->stack.empty()) {
+                return 0;
+            }
+
+            this->stack.push(peek_register(instr.reg));
+            this->stack.push(peek_register(static_cast<char>(instr.operand >> 8)));
+            Macro::fetch_comparison(static_cast<MacroOP>(instr.aux), cmp_reg, this->stack, this->regs, dc_macro);
+
+            return 3;
         }
+        case OpCode::FOLD: {
+            const auto &fold = prog.folds[instr.operand];
+            if(this->parameters.precision != fold.precision || this->parameters.iradix != 10) {
+                return 0;
+            }
+
+            const auto &last_values = fold.last_values[std::min(len, Fold::MAX_DEPTH)];
+            if(auto last_x = resolve_last_value(last_values[0])) {
+                this->stack.set_last_x(std::move(*last_x));
+            }
+            if(auto last_y = resolve_last_value(last_values[1])) {
+                this->stack.set_last_y(std::move(*last_y));
+            }
+            if(auto last_z = resolve_last_value(last_values[2])) {
+                this->stack.set_last_z(std::move(*last_z));
+            }
+
+            for(const auto &result : fold.results) {
+                this->stack.push(result);
+            }
+
+            return fold.length;
+        }
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Computes a last value set by a folded sequence
+ * @param last The effect of the sequence on the last value
+ * @return The new last value, std::nullopt if the last value is not changed
+ */
+std::optional<dc::Value> Evaluate::resolve_last_value(const Fold::LastValue &last) {
+    switch(last.source) {
+        case Fold::LastValue::Source::CONSTANT: return last.value;
+        case Fold::LastValue::Source::STACK: return this->stack[this->stack.size() - 1 - last.index];
+        case Fold::LastValue::Source::KEEP: break;
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Gets the head of a register's stack
+ * @param reg_name The register's name
+ * @return The head of the register's stack, zero if the register is undefined or empty
+ */
+dc::Value Evaluate::peek_register(char reg_name) {
+    auto *reg = this->regs.find(reg_name);
+    if(reg == nullptr || reg->stack.empty()) {
+        return dc::Value(0.0, 0);
+    }
+
+    return reg->stack.top();
+}
+
+/**
+ * @brief Pushes a literal onto the stack
+ * @param literal The literal value
+ * @return Parsing errors, if any
+ */
+std::optional<dc::Error> Evaluate::push_literal(const dc::Value &literal) {
+    if(this->parameters.iradix != 10) {
+        return parse_base_n(literal.to_string());
+    }
+
+    if(!literal.is_number()) {
+        return dc::Error(dc::ErrorCode::UNRECOGNIZED_OPTION);
     }
 
-    return err;
+    this->stack.push(literal);
+
+    return std::nullopt;
 }
 
 /**
- * @brief Parses a DC register command.
- * @param token The command followed by the register's name
+ * @brief Parses numbers in a non decimal numeric system
+ * @param token The value to be parsed in the chosen base
  * @return Parsing errors, if any
  */
-std::optional<std::string> Evaluate::parse_register_command(std::string token) {
+std::optional<dc::Error> Evaluate::parse_base_n(const std::string& token) {
+    // Discard values that are neither integers neither within "ABCDEF"
+    if(!NumericUtils::is_numeric<long>(token) && !X_CONTAINS_Y("ABCDEF", token)) {
+        return dc::Error(dc::ErrorCode::INTEGER_INPUT);
+    }
+
+    // Try to convert the number to the selected numeric base
+    try {
+        long number = std::stol(token, nullptr, this->parameters.iradix);
+        this->stack.push(dc::Value(std::to_string(number)));
+    } catch(...) {
+        return dc::Error(dc::ErrorCode::INVALID_NUMBER, '\0', this->parameters.iradix);
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Executes a DC register command.
+ * @param opcode The register command
+ * @param reg_name The register's name
+ * @return Evaluation errors, if any
+ */
+std::optional<dc::Error> Evaluate::register_command(OpCode opcode, char reg_name) {
     // A register command has length equal to 2
     // and starts either with 's', 'l'(i.e. "sX" or "lX")
     // or with 'S' or 'L'(i.e., "SX", "LX")
-    if(token.at(0) == 's') {
+    if(opcode == OpCode::STORE) {
         // Check if main stack is empty
         if(this->stack.empty()) {
-            return "This operation does not work on empty stack";
+            return dc::Error(dc::ErrorCode::EMPTY_STACK);
         }
 
         // Otherwise pop an element from main stack and store it into
         // the register's top-of-the-stack. Any previous value gets overwritten
         this->stack.copy_xyz();
-        auto reg_name = token.at(1);
         auto head = this->stack.pop(true);
 
-        // If register's stack exist, overwrite top of the stack
-        // Otherwise allocate a new instance of the register
-        auto it = this->regs.find(reg_name);
-        if(it != this->regs.end()) { // Register exist
-            // If register exists but stack is empty, push the first element
-            if(it->second.stack.empty()) {
-                it->second.stack.push(head);
-            } else {
-                auto head_idx = it->second.stack.size()-1;
-                it->second.stack[head_idx] = head;
-            }
-        } else { // Register does not exist
-            this->regs[reg_name] = dc::Register{
-                dc::Stack<std::string>(),
-                std::unordered_map<int, std::string>()
-            };
-            this->regs[reg_name].stack.push(head);
+        // Allocate the register if it does not exist
+        auto &reg_stack = this->regs[reg_name].stack;
+        // If register's stack is empty, push the first element
+        // Otherwise overwrite top of the stack
+        if(reg_stack.empty()) {
+            reg_stack.push(std::move(head));
+        } else {
+            reg_stack.set(reg_stack.size()-1, std::move(head));
         }
-    } else if(token.at(0) == 'S') {
+    } else if(opcode == OpCode::PUSH_REG) {
         // An uppercase 'S' pops the top of the main stack and
         // pushes it onto the stack of selected register.
         // The previous value of the register's stack becomes
@@ -335,163 +516,127 @@ std::optional<std::string> Evaluate::parse_register_command(std::string token) {
 
         // Check if main stack is empty
         if(this->stack.empty()) {
-            return "This operation does not work on empty stack";
+            return dc::Error(dc::ErrorCode::EMPTY_STACK);
         }
 
         this->stack.copy_xyz();
-        auto reg_name = token.at(1);
         auto head = this->stack.pop(true);
 
-        // If register's stack exist, push an element onto its stack
-        // otherwise allocate a new instance of the register
-        auto it = this->regs.find(reg_name);
-        if(it != this->regs.end()) { // Register exists
-            it->second.stack.push(head);
-        } else { // Register doesn't exist
-            this->regs[reg_name] = dc::Register{
-                dc::Stack<std::string>(),
-                std::unordered_map<int, std::string>()
-            };
-            this->regs[reg_name].stack.push(head);
-        }
-    } else if(token.at(0) == 'L') {
+        // Push an element onto register's stack, allocating
+        // the register if it does not exist
+        this->regs[reg_name].stack.push(std::move(head));
+    } else if(opcode == OpCode::POP_REG) {
         // An uppercase 'L' pops the top of the register's stack
 	    // abd pushes it onto the main stack. The previous register's stack
     	// value, if any, is accessible via the lowercase 'l' command
-        auto reg_name = token.at(1);
 
         // Check if register exists
-        if(this->regs.find(reg_name) == this->regs.end()) {
-            return std::string("Register '") + reg_name + std::string("' is undefined");
+        auto *reg = this->regs.find(reg_name);
+        if(reg == nullptr) {
+            return dc::Error(dc::ErrorCode::UNDEFINED_REGISTER, reg_name);
         }
 
         // Check if register's stack is empty
-        if(this->regs[reg_name].stack.empty()) {
-            return std::string("The stack of register '") + reg_name + std::string("' is empty");
+        if(reg->stack.empty()) {
+            return dc::Error(dc::ErrorCode::EMPTY_REGISTER, reg_name);
         }
 
         // Otherwise, pop an element from the register's stack and push it onto the main stack
-        auto value = this->regs[reg_name].stack.pop(true);
-        this->stack.push(value);
-    } else if(token.at(0) == 'l') {
+        this->stack.push(reg->stack.pop(true));
+    } else if(opcode == OpCode::LOAD) {
         // Otherwise retrieve the register name and push its value
     	// to the stack without altering the register's stack.
 	    // If the register is empty, push '0' to the stack
-        auto reg_name = token.at(1);
 
         // If register does not exist or its stack is empty, push '0' onto the main stack
-        auto it = this->regs.find(reg_name);
-        if(it == this->regs.end() || it->second.stack.empty()) {
-            this->stack.push("0");
-            return std::nullopt;
-        }
-
-        // Otherwise, peek an element from the register's stack and push it onto the main stack
-        auto value = this->regs[reg_name].stack.pop(false);
-        this->stack.push(value);
-    } else if(token.at(0) == 'c') {
+        this->stack.push(peek_register(reg_name));
+    } else if(opcode == OpCode::CLEAR_REG) {
         // Delete register from memory
-        auto reg_name = token.at(1);
         this->regs.erase(reg_name);
-    } else if(token.at(0) == 'z') {
+    } else if(opcode == OpCode::REG_SIZE) {
         // Pushes register's stack size on main stack
-        auto reg_name = token.at(1);
-        auto size = std::to_string(this->regs[reg_name].stack.size());
-        this->stack.push(size);
+        auto size = this->regs[reg_name].stack.size();
+        this->stack.push(dc::Value(static_cast<double>(size), 0));
     } else {
-        return "Unmanaged error";
+        return dc::Error(dc::ErrorCode::UNMANAGED);
     }
 
     return std::nullopt;
 }
 
 /**
- * @brief Parses DC array commands
- * @param token The command followed by the array name
- * @return Parsing errors, if any.
+ * @brief Executes DC array commands
+ * @param opcode The array command
+ * @param reg_name The array name
+ * @return Evaluation errors, if any.
  */
-std::optional<std::string> Evaluate::parse_array_command(std::string token) {
+std::optional<dc::Error> Evaluate::array_command(OpCode opcode, char reg_name) {
     // An array command has length equal to 2, starts
     // with either ':'(store) or ';'(read) and ends with
     // the register name(i.e., ':X' or ';X')
-    if(token.at(0) == ':') {
+    if(opcode == OpCode::ARRAY_STORE) {
         // An ':' command pops two values from the main stack. The second-to-top
 	    // element will be stored in the array indexed by the top-of-stack.
-        auto reg_name = token.at(1);
 
         // Check if the main stack has enough elements
         if(this->stack.size() < 2) {
-            return "This operation requires two values";
+            return dc::Error(dc::ErrorCode::REQUIRES_TWO_VALUES);
         }
 
         // Extract two elements from the main stack
         this->stack.copy_xyz();
-        auto idx_str = this->stack.pop(true);
+        auto idx_val = this->stack.pop(true);
         auto arr_val = this->stack.pop(true);
 
         // Check whether the index is an integer
-        if(!NumericUtils::is_numeric<int>(idx_str)) {
-            return "Array index must be an integer";
+        if(!idx_val.is_integer()) {
+            return dc::Error(dc::ErrorCode::INVALID_ARRAY_INDEX);
         }
 
         // Otherwise convert it into an integer
-        auto idx = std::stoi(idx_str);
-
-        // If array exists, store 'p' at index 'i' on array 'r'
-        // If array does not exist, allocate a new array first
-        auto it = this->regs.find(reg_name);
-        if(it != this->regs.end()) { // Register exists
-            // Always discard previous values of array
-            it->second.array.erase(idx);
-            it->second.array.insert(std::pair<int, std::string>(idx, arr_val));
-        } else { // Register doesn't exist
-            this->regs[reg_name] = dc::Register{
-                dc::Stack<std::string>(),
-                std::unordered_map<int, std::string>{{idx, arr_val}}
-            };
-        }
+        auto idx = idx_val.to_int();
+
+        // Store 'p' at index 'i' on array 'r', allocating the register if it does not exist.
+        // Always discard previous values of array
+        this->regs[reg_name].array.store(idx, std::move(arr_val));
     } else {
         // An ';' command pops top-of-stack abd uses it as an index
     	// for the array. The selected value, if any, is pushed onto the stack
-        auto reg_name = token.at(1);
 
         // Check if the main stack is empty
         if(this->stack.empty()) {
-            return "This operation requires one value";
+            return dc::Error(dc::ErrorCode::REQUIRES_ONE_VALUE);
         }
 
         // Extract the index from the stack
         this->stack.copy_xyz();
-        auto idx_str = this->stack.pop(true);
+        auto idx_val = this->stack.pop(true);
 
         // Check if index is an integer
-        if(!NumericUtils::is_numeric<int>(idx_str)) {
-            return "Array index must be an integer";
+        if(!idx_val.is_integer()) {
+            return dc::Error(dc::ErrorCode::INVALID_ARRAY_INDEX);
         }
 
         // Otherwise, convert it to integer
-        auto idx = std::stoi(idx_str);
+        auto idx = idx_val.to_int();
 
         // Check if the array exists
-        if(this->regs.find(reg_name) == this->regs.end()) {
-            return std::string("Register '") + reg_name + std::string("' is undefined");
+        auto *reg = this->regs.find(reg_name);
+        if(reg == nullptr) {
+            return dc::Error(dc::ErrorCode::UNDEFINED_REGISTER, reg_name);
         }
 
         // Check if array is empty
-        if(this->regs[reg_name].array.empty()) {
-            return std::string("The array of register '") + reg_name + std::string("' is empty");
+        if(reg->array.empty()) {
+            return dc::Error(dc::ErrorCode::EMPTY_ARRAY, reg_name);
         }
 
         // Otherwise, use the index to retrieve the array element
         // and to push it onto the main stack
-        auto reg_it = regs.find(reg_name);
-        auto arr_it = reg_it->second.array.find(idx);
-
-        if(arr_it != reg_it->second.array.end()) {
-            this->stack.push(arr_it->second);
+        if(const auto *value = reg->array.find(idx)) {
+            this->stack.push(*value);
         } else {
-            return std::string("Cannot access ") + reg_name +
-                   std::string("[") + std::to_string(idx) + std::string("]");
+            return dc::Error(dc::ErrorCode::ARRAY_OUT_OF_BOUNDS, reg_name, idx);
         }
     }
 
@@ -1,45 +1,77 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 #include <optional>
 #include <memory>
-#include <functional>
+#include <memory_resource>
 
 #include "adt.h"
 #include "operation.h"
+#include "compiler.h"
+#include "macro.h"
 
 /**
  * @brief Evaluates DC commands
  *
- *  Parses and evaluates DC commands.
+ *  Compiles DC commands into a program and executes it on the DC virtual machine.
  */
 class Evaluate {
 public:
     /**
      * @brief Constructor of Evaluate.
-     * @param e The expression to be evaluated
-     * @param r An instance of the dc::Register data structure
+     * @param e The source code of the expression to be evaluated
+     * @param r An instance of the dc::RegisterFile data structure
      * @param s An instance of the dc::Stack data structure
      * @param p An instance of the dc::Parameters data structure
+     * @param mr The memory resource the program and the frames are allocated by(e.g., a dc::Arena)
      */
-    Evaluate(const std::vector<std::string>& e, std::unordered_map<char, dc::Register> &r,
-             dc::Stack<std::string> &s, dc::Parameters &p)
-        : expr(e), regs(r), stack(s), parameters(p) {}
-    std::optional<std::string> eval();
+    Evaluate(std::string_view e, dc::RegisterFile &r, dc::Stack<dc::Value> &s, dc::Parameters &p,
+             std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+        : program(std::allocate_shared<const Program>(std::pmr::polymorphic_allocator<Program>(mr),
+                                                      Compiler::compile(e, p, mr))),
+          regs(r), stack(s), parameters(p), resource(mr) {}
+
+    /**
+     * @brief Overload of Evaluate constructor
+     *
+     * Executes an already compiled program
+     * @param prog The compiled program to be executed
+     * @param r An instance of the dc::RegisterFile data structure
+     * @param s An instance of the dc::Stack data structure
+     * @param p An instance of the dc::Parameters data structure
+     */
+    Evaluate(std::shared_ptr<const Program> prog, dc::RegisterFile &r,
+             dc::Stack<dc::Value> &s, dc::Parameters &p)
+        : program(std::move(prog)), regs(r), stack(s), parameters(p) {}
+    std::optional<dc::Error> eval();
+    static void set_threaded(bool enabled);
 
 private:
-    std::optional<std::string> parse_macro(std::size_t &idx);
-    std::optional<std::string> parse_macro_command(std::string token);
-    std::optional<std::string> parse_register_command(std::string token);
-    std::optional<std::string> parse_array_command(std::string token);
-    std::optional<std::string> parse_base_n(const std::string& token);
-    void init_environment();
+    /**
+     * @brief An activation record of the virtual machine
+     */
+    struct Frame {
+        std::shared_ptr<const Program> program;
+        std::size_t pc;
+        std::size_t checked;    // Leading instructions whose operands have been checked when the frame has been entered
+    };
+
+    template<bool threaded>
+    std::optional<dc::Error> run(std::pmr::vector<Frame> &frames);
+    void call(std::pmr::vector<Frame> &frames, const dc::SharedString &dc_macro);
+    std::size_t checked_prefix(const Program &prog);
+    std::size_t exec_fused(const Instruction &instr, const Program &prog, dc::SharedString &dc_macro);
+    dc::Value peek_register(char reg_name);
+    std::optional<dc::Value> resolve_last_value(const Fold::LastValue &last);
+    std::optional<dc::Error> push_literal(const dc::Value &literal);
+    std::optional<dc::Error> register_command(OpCode opcode, char reg_name);
+    std::optional<dc::Error> array_command(OpCode opcode, char reg_name);
+    std::optional<dc::Error> parse_base_n(const std::string& token);
 
-    using op_factory_t = std::function<std::unique_ptr<IOperation>()>;
-    std::vector<std::string> expr;
-    std::unordered_map<char, dc::Register> &regs;
-    std::unordered_map<std::string, op_factory_t> op_factory;
-    dc::Stack<std::string> &stack;
+    std::shared_ptr<const Program> program;
+    dc::RegisterFile &regs;
+    dc::Stack<dc::Value> &stack;
     dc::Parameters &parameters;
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource();
 };
@@ -0,0 +1,820 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <bit>
+#include <memory_resource>
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define DC_JIT_SUPPORTED
+#endif
+
+#include "adt.cpp"
+#include "jit.h"
+#include "macro.h"
+
+static bool jit_enabled = false;
+
+namespace {
+    /**
+     * @brief An arithmetic operation or a comparison between two cells
+     */
+    struct NativeOp {
+        enum class Kind : std::uint8_t { ADD, SUB, MUL, DIV, MOD, SQRT, CMP };
+
+        Kind kind;
+        std::size_t lhs;
+        std::size_t rhs;
+        std::size_t result;
+        MacroOP cmp;
+    };
+
+    /**
+     * @brief An element marked as a last value: either a cell or an element
+     * that the macro has not reached yet, counting from the head of the stack
+     */
+    struct LastMark {
+        bool is_cell;
+        std::size_t index;
+    };
+
+    /**
+     * @brief Assigns cells to the values of a macro by tracing its stack effect
+     */
+    struct Trace {
+        std::vector<std::size_t> stack;         // Cells of the elements pushed by the macro
+        std::vector<std::size_t> inputs;        // Cells of the elements consumed by the macro, from the head
+        std::vector<bool> computed;             // Whether a cell is written by the machine code
+        std::vector<std::pair<std::size_t, std::uint32_t>> literals;
+        std::vector<std::array<LastMark, 3>> marks;
+        std::vector<NativeOp> ops;
+
+        std::size_t cell(bool is_computed) {
+            this->computed.push_back(is_computed);
+
+            return this->computed.size() - 1;
+        }
+
+        std::size_t pop() {
+            // Elements below the ones pushed by the macro are inputs
+            if(this->stack.empty()) {
+                auto input = cell(false);
+                this->inputs.push_back(input);
+
+                return input;
+            }
+
+            auto top = this->stack.back();
+            this->stack.pop_back();
+
+            return top;
+        }
+
+        void copy_xyz() {
+            std::array<LastMark, 3> mark{};
+            for(std::size_t pos = 0; pos < mark.size(); pos++) {
+                if(pos < this->stack.size()) {
+                    mark[pos] = LastMark{true, this->stack[this->stack.size() - 1 - pos]};
+                } else {
+                    mark[pos] = LastMark{false, this->inputs.size() + (pos - this->stack.size()) + 1};
+                }
+            }
+            this->marks.push_back(mark);
+        }
+
+        void binary(NativeOp::Kind kind) {
+            copy_xyz();
+            auto rhs = pop();
+            auto lhs = pop();
+            auto result = cell(true);
+            this->ops.push_back(NativeOp{kind, lhs, rhs, result, MacroOP::GT});
+            this->stack.push_back(result);
+        }
+    };
+
+#ifdef DC_JIT_SUPPORTED
+    // Registers of the generated code: rbx holds the cells, r12 the flags
+    // of the cells(see Jit::run) and r13d the precision
+    constexpr std::uint8_t XMM0 = 0;
+    constexpr std::uint8_t XMM1 = 1;
+    constexpr std::uint8_t XMM2 = 2;
+
+    /**
+     * @brief Emits x86-64 machine code
+     */
+    class Assembler {
+    public:
+        std::vector<std::uint8_t> code;
+
+        void emit(std::initializer_list<std::uint8_t> bytes) {
+            this->code.insert(this->code.end(), bytes);
+        }
+
+        void emit32(std::uint32_t value) {
+            for(int shift = 0; shift < 32; shift += 8) {
+                this->code.push_back(static_cast<std::uint8_t>(value >> shift));
+            }
+        }
+
+        void emit64(std::uint64_t value) {
+            emit32(static_cast<std::uint32_t>(value));
+            emit32(static_cast<std::uint32_t>(value >> 32));
+        }
+
+        // [rbx + 8 * cell] as the operand of an SSE instruction
+        void sse(std::uint8_t prefix, std::uint8_t opcode, std::uint8_t xmm, std::size_t cell) {
+            emit({prefix, 0x0F, opcode, static_cast<std::uint8_t>(0x83 | (xmm << 3))});
+            emit32(static_cast<std::uint32_t>(cell * sizeof(double)));
+        }
+
+        void load(std::uint8_t xmm, std::size_t cell) { sse(0xF2, 0x10, xmm, cell); }        // movsd xmm, [cell]
+        void store(std::size_t cell) { sse(0xF2, 0x11, XMM0, cell); }                       // movsd [cell], xmm0
+
+        // mov byte [r12 + offset], value
+        void set_flag(std::size_t offset, std::uint8_t value) {
+            emit({0x41, 0xC6, 0x84, 0x24});
+            emit32(static_cast<std::uint32_t>(offset));
+            emit({value});
+        }
+
+        // cmp byte [r12 + offset], value
+        void test_flag(std::size_t offset, std::uint8_t value) {
+            emit({0x41, 0x80, 0xBC, 0x24});
+            emit32(static_cast<std::uint32_t>(offset));
+            emit({value});
+        }
+
+        // jcc to the deoptimisation stub, patched by Assembler::finish
+        void deopt_if(std::uint8_t condition) {
+            emit({0x0F, condition});
+            this->deopts.push_back(this->code.size());
+            emit32(0);
+        }
+
+        void finish() {
+            // Epilogue: pop r13, pop r12, pop rbx, ret
+            emit({0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3});
+
+            auto stub = this->code.size();
+            for(auto pos : this->deopts) {
+                auto rel = static_cast<std::uint32_t>(stub - (pos + 4));
+                std::memcpy(this->code.data() + pos, &rel, sizeof(rel));
+            }
+            // mov eax, -1, followed by the epilogue
+            emit({0xB8, 0xFF, 0xFF, 0xFF, 0xFF, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3});
+        }
+
+    private:
+        std::vector<std::size_t> deopts;
+    };
+
+    constexpr std::uint8_t JE = 0x84;
+    constexpr std::uint8_t JNE = 0x85;
+    constexpr std::uint8_t JB = 0x82;
+    constexpr std::uint8_t JP = 0x8A;
+#endif
+}
+
+/**
+ * @brief Rounds the result of an operation like dc::Value does
+ *
+ * Called by the machine code for results that are not integers
+ *
+ * @param number The result of the operation
+ * @param precision The precision of the operation
+ * @return The rounded number
+ */
+static double round_result(double number, unsigned int precision) {
+    return dc::Value(number, precision).to_double();
+}
+
+/**
+ * @brief Returns true if a value is accepted by the modulo operation, false otherwise
+ *
+ * Only values that can be converted to an integer without parsing their text are accepted
+ *
+ * @param number The value of the cell
+ * @param origin The value the cell has been read from, if any
+ * @param rounded Whether the cell has been rounded
+ * @return Boolean value
+ */
+static bool fits_long(double number, const dc::Value *origin, bool rounded) {
+    if(origin != nullptr) {
+        return origin->is_long() && std::abs(number) <= 0x1p53;
+    }
+
+    return !rounded && std::trunc(number) == number && number >= -0x1p63 && number < 0x1p63;
+}
+
+/**
+ * @brief Creates the value of a cell
+ * @param number The value of the cell
+ * @param origin The value the cell has been read from, if any
+ * @param rounded Whether the cell has been rounded
+ * @param precision The precision of the operation that has computed the cell
+ * @return The value of the cell
+ */
+static dc::Value materialize(double number, const dc::Value *origin, bool rounded, unsigned int precision) {
+    if(origin != nullptr) {
+        return *origin;
+    }
+
+    // Rounding a number with no precision keeps two decimal digits, even if the rounded number is an integer
+    return dc::Value(number, (rounded && precision == 0) ? 2 : precision);
+}
+
+#ifdef DC_JIT_SUPPORTED
+/**
+ * @brief Emits the checks and the rounding of the result of an operation, held in xmm0, and stores it
+ *
+ * @param as The assembler
+ * @param result The cell of the result
+ * @param flush Whether results close to zero are flushed to zero, like the subtraction does
+ */
+static void emit_result(Assembler &as, std::size_t result, bool flush) {
+    // Results that are not finite are strings: movq rax, xmm0; shl rax, 1; shr rax, 53; cmp eax, 0x7FF
+    as.emit({0x66, 0x48, 0x0F, 0x7E, 0xC0, 0x48, 0xD1, 0xE0, 0x48, 0xC1, 0xE8, 0x35, 0x3D});
+    as.emit32(0x7FF);
+    as.deopt_if(JE);
+
+    if(flush) {
+        // Flush results smaller than the epsilon to zero:
+        // movq rax, xmm0; btr rax, 63; movq xmm1, rax; mov rax, 1e-10; movq xmm2, rax; ucomisd xmm1, xmm2
+        as.emit({0x66, 0x48, 0x0F, 0x7E, 0xC0, 0x48, 0x0F, 0xBA, 0xF0, 0x3F, 0x66, 0x48, 0x0F, 0x6E, 0xC8, 0x48, 0xB8});
+        as.emit64(std::bit_cast<std::uint64_t>(1e-10));
+        as.emit({0x66, 0x48, 0x0F, 0x6E, 0xD0, 0x66, 0x0F, 0x2E, 0xCA});
+        // jae keep; xorpd xmm0, xmm0
+        as.emit({0x73, 0x04, 0x66, 0x0F, 0x57, 0xC0});
+    }
+
+    // Integers are not rounded. Numbers from 2^52 on are integers: movq rax, xmm0; shl rax, 1; shr rax, 53; cmp eax, 1075
+    as.emit({0x66, 0x48, 0x0F, 0x7E, 0xC0, 0x48, 0xD1, 0xE0, 0x48, 0xC1, 0xE8, 0x35, 0x3D});
+    as.emit32(1075);
+    // jae integer; cvttsd2si rax, xmm0; cvtsi2sd xmm1, rax; ucomisd xmm0, xmm1; jne round; jp round
+    as.emit({0x73, 0x12, 0xF2, 0x48, 0x0F, 0x2C, 0xC0, 0xF2, 0x48, 0x0F, 0x2A, 0xC8, 0x66, 0x0F, 0x2E, 0xC1});
+    as.emit({0x75, 0x0D, 0x7A, 0x0B});
+    // integer: clear the rounding flag; jmp done
+    as.set_flag(Jit::MAX_CELLS + result, 0);
+    as.emit({0xEB, 0x18});
+    // round: set the rounding flag; mov edi, r13d; mov rax, round_result; call rax
+    as.set_flag(Jit::MAX_CELLS + result, 1);
+    as.emit({0x44, 0x89, 0xEF, 0x48, 0xB8});
+    as.emit64(reinterpret_cast<std::uintptr_t>(&round_result));
+    as.emit({0xFF, 0xD0});
+    // done:
+    as.store(result);
+}
+
+/**
+ * @brief Emits a check that a cell is accepted by the modulo operation
+ * @param as The assembler
+ * @param cell The cell to be checked
+ * @param computed Whether the cell is written by the machine code
+ */
+static void emit_long_check(Assembler &as, std::size_t cell, bool computed) {
+    if(!computed) {
+        as.test_flag(cell, 0);
+        as.deopt_if(JE);
+
+        return;
+    }
+
+    // Results of the macro have no decimal digits when they have not been rounded
+    // and are integers: cvttsd2si rax, xmm0; cvtsi2sd xmm2, rax; ucomisd xmm0, xmm2
+    as.test_flag(Jit::MAX_CELLS + cell, 0);
+    as.deopt_if(JNE);
+    as.load(XMM0, cell);
+    as.emit({0xF2, 0x48, 0x0F, 0x2C, 0xC0, 0xF2, 0x48, 0x0F, 0x2A, 0xD0, 0x66, 0x0F, 0x2E, 0xC2});
+    as.deopt_if(JNE);
+    as.deopt_if(JP);
+}
+
+/**
+ * @brief Emits the machine code of an operation
+ * @param as The assembler
+ * @param op The operation
+ * @param trace The trace of the macro
+ */
+static void emit_op(Assembler &as, const NativeOp &op, const Trace &trace) {
+    switch(op.kind) {
+        case NativeOp::Kind::ADD:
+        case NativeOp::Kind::SUB:
+        case NativeOp::Kind::MUL: {
+            static constexpr std::uint8_t opcodes[] = {0x58, 0x5C, 0x59};
+            as.load(XMM0, op.lhs);
+            as.sse(0xF2, opcodes[static_cast<std::size_t>(op.kind)], XMM0, op.rhs);
+            emit_result(as, op.result, op.kind == NativeOp::Kind::SUB);
+            break;
+        }
+        case NativeOp::Kind::DIV: {
+            // Division by zero raises an error: xorpd xmm2, xmm2; ucomisd xmm1, xmm2
+            as.load(XMM1, op.rhs);
+            as.emit({0x66, 0x0F, 0x57, 0xD2, 0x66, 0x0F, 0x2E, 0xCA});
+            as.deopt_if(JE);
+            // divsd xmm0, xmm1
+            as.load(XMM0, op.lhs);
+            as.emit({0xF2, 0x0F, 0x5E, 0xC1});
+            emit_result(as, op.result, false);
+            break;
+        }
+        case NativeOp::Kind::MOD: {
+            emit_long_check(as, op.lhs, trace.computed[op.lhs]);
+            emit_long_check(as, op.rhs, trace.computed[op.rhs]);
+            // cvttsd2si rax, xmm0; cvttsd2si rcx, xmm1; test rcx, rcx
+            as.load(XMM0, op.lhs);
+            as.load(XMM1, op.rhs);
+            as.emit({0xF2, 0x48, 0x0F, 0x2C, 0xC0, 0xF2, 0x48, 0x0F, 0x2C, 0xC9, 0x48, 0x85, 0xC9});
+            as.deopt_if(JE);
+            // The remainder of the smallest integer by -1 traps: cmp rcx, -1
+            as.emit({0x48, 0x83, 0xF9, 0xFF});
+            as.deopt_if(JE);
+            // cqo; idiv rcx; cvtsi2sd xmm0, rdx
+            as.emit({0x48, 0x99, 0x48, 0xF7, 0xF9, 0xF2, 0x48, 0x0F, 0x2A, 0xC2});
+            as.set_flag(Jit::MAX_CELLS + op.result, 0);
+            as.store(op.result);
+            break;
+        }
+        case NativeOp::Kind::SQRT: {
+            // The square root of a negative number is complex: xorpd xmm2, xmm2; ucomisd xmm0, xmm2
+            as.load(XMM0, op.lhs);
+            as.emit({0x66, 0x0F, 0x57, 0xD2, 0x66, 0x0F, 0x2E, 0xC2});
+            as.deopt_if(JB);
+            // sqrtsd xmm0, xmm0
+            as.emit({0xF2, 0x0F, 0x51, 0xC0});
+            emit_result(as, op.result, false);
+            break;
+        }
+        case NativeOp::Kind::CMP: {
+            // The head of the stack is the left-hand side
+            as.load(XMM0, op.lhs);
+            as.load(XMM1, op.rhs);
+            bool swapped = (op.cmp == MacroOP::LT || op.cmp == MacroOP::LEQ);
+            // ucomisd xmm0, xmm1 or ucomisd xmm1, xmm0
+            as.emit({0x66, 0x0F, 0x2E, static_cast<std::uint8_t>(swapped ? 0xC8 : 0xC1)});
+            std::uint8_t setcc = 0;
+            switch(op.cmp) {
+                case MacroOP::GT: case MacroOP::LT: setcc = 0x97; break;
+                case MacroOP::GEQ: case MacroOP::LEQ: setcc = 0x93; break;
+                case MacroOP::EQ: setcc = 0x94; break;
+                case MacroOP::NEQ: setcc = 0x95; break;
+            }
+            // setcc al; movzx eax, al
+            as.emit({0x0F, setcc, 0xC0, 0x0F, 0xB6, 0xC0});
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Maps machine code into executable memory
+ * @param code The machine code
+ * @param memory The mapped memory
+ * @param size The size of the mapped memory
+ * @return false if the memory cannot be mapped, true otherwise
+ */
+static bool map_code(const std::vector<std::uint8_t> &code, void *&memory, std::size_t &size) {
+    auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    size = (code.size() + page - 1) / page * page;
+
+    // Pages are never writable and executable at the same time
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(memory == MAP_FAILED) {
+        memory = nullptr;
+        return false;
+    }
+
+    std::memcpy(memory, code.data(), code.size());
+    if(mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, size);
+        memory = nullptr;
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+/**
+ * @brief Releases the memory of the machine code
+ */
+NativeCode::~NativeCode() {
+#ifdef DC_JIT_SUPPORTED
+    if(this->memory != nullptr) {
+        munmap(this->memory, this->size);
+    }
+#endif
+}
+
+/**
+ * @brief Enables the compilation of numeric macros into native code
+ * @param enabled Whether macros entering the macro cache are compiled
+ */
+void Jit::set_enabled(bool enabled) {
+    jit_enabled = enabled;
+}
+
+/**
+ * @brief Returns true if numeric macros are compiled into native code, false otherwise
+ * @return Boolean value
+ */
+bool Jit::is_enabled() {
+    return jit_enabled;
+}
+
+/**
+ * @brief Compiles a macro into native code
+ *
+ * The instructions of the macro are traced to assign a cell to each value, then the arithmetic
+ * is emitted as machine code. The effect of the macro on the last values is computed for each
+ * number of elements below the ones the macro consumes, like folded sequences do(see Fold)
+ *
+ * @param program The compiled macro
+ * @return The native code of the macro, or nullptr if the macro cannot be compiled
+ */
+std::shared_ptr<const NativeCode> Jit::compile(const Program &program) {
+#ifdef DC_JIT_SUPPORTED
+    Trace trace;
+    std::vector<NativeCode::RegisterSlot> registers;
+    auto find_register = [&registers](char reg) {
+        return std::find_if(registers.begin(), registers.end(),
+                            [reg](const auto &slot) { return slot.reg == reg; });
+    };
+    char compare_reg = 0;
+
+    for(std::size_t pc = 0; pc < program.code.size(); pc++) {
+        auto instr = Compiler::is_fused(program.code[pc].opcode)
+                     ? Compiler::unfuse(program, program.code[pc]) : program.code[pc];
+        switch(instr.opcode) {
+            case OpCode::PUSH: {
+                // Literals that are not real numbers are left to the virtual machine
+                if(!program.literals[instr.operand].is_number()) {
+                    return nullptr;
+                }
+                auto literal = trace.cell(false);
+                trace.stack.push_back(literal);
+                trace.literals.emplace_back(literal, instr.operand);
+                break;
+            }
+            case OpCode::OPERATION: {
+                switch(static_cast<OPType>(instr.operand)) {
+                    case OPType::ADD: trace.binary(NativeOp::Kind::ADD); break;
+                    case OPType::SUB: trace.binary(NativeOp::Kind::SUB); break;
+                    case OPType::MUL: trace.binary(NativeOp::Kind::MUL); break;
+                    case OPType::DIV: trace.binary(NativeOp::Kind::DIV); break;
+                    case OPType::MOD: trace.binary(NativeOp::Kind::MOD); break;
+                    case OPType::SQRT: {
+                        trace.copy_xyz();
+                        auto operand = trace.pop();
+                        auto result = trace.cell(true);
+                        trace.ops.push_back(NativeOp{NativeOp::Kind::SQRT, operand, operand, result, MacroOP::GT});
+                        trace.stack.push_back(result);
+                        break;
+                    }
+                    case OPType::DP: {
+                        auto head = trace.pop();
+                        trace.stack.insert(trace.stack.end(), {head, head});
+                        break;
+                    }
+                    case OPType::SO: {
+                        trace.copy_xyz();
+                        auto head = trace.pop();
+                        auto second = trace.pop();
+                        trace.stack.insert(trace.stack.end(), {head, second});
+                        break;
+                    }
+                    case OPType::PH: {
+                        trace.copy_xyz();
+                        trace.pop();
+                        break;
+                    }
+                    default: return nullptr;
+                }
+                break;
+            }
+            case OpCode::LOAD: {
+                auto slot = find_register(instr.reg);
+                if(slot == registers.end()) {
+                    auto input = trace.cell(false);
+                    registers.push_back(NativeCode::RegisterSlot{instr.reg, true, false, input, input});
+                    slot = std::prev(registers.end());
+                }
+                trace.stack.push_back(slot->output);
+                break;
+            }
+            case OpCode::STORE: {
+                trace.copy_xyz();
+                auto value = trace.pop();
+                auto slot = find_register(instr.reg);
+                if(slot == registers.end()) {
+                    // The input of a register that is written before being read only
+                    // holds the value of the register between iterations of a loop
+                    registers.push_back(NativeCode::RegisterSlot{instr.reg, false, true, trace.cell(false), value});
+                } else {
+                    slot->stored = true;
+                    slot->output = value;
+                }
+                break;
+            }
+            case OpCode::CMP: {
+                // Only a final comparison can be compiled
+                if(pc + 1 != program.code.size()) {
+                    return nullptr;
+                }
+                trace.copy_xyz();
+                auto head = trace.pop();
+                auto second = trace.pop();
+                trace.ops.push_back(NativeOp{NativeOp::Kind::CMP, head, second, 0, static_cast<MacroOP>(instr.aux)});
+                compare_reg = instr.reg;
+                break;
+            }
+            default: return nullptr;
+        }
+    }
+
+    auto is_compare = !trace.ops.empty() && trace.ops.back().kind == NativeOp::Kind::CMP;
+    auto stored = [&registers](char reg) {
+        return std::any_of(registers.begin(), registers.end(),
+                           [reg](const auto &slot) { return slot.reg == reg && slot.stored; });
+    };
+    // Macros without arithmetic are not worth compiling, while macros
+    // that overwrite the macro they call are left to the virtual machine
+    if(trace.ops.empty() || trace.computed.size() > MAX_CELLS || trace.inputs.size() > MAX_WINDOW ||
+       trace.stack.size() > MAX_WINDOW || registers.size() > MAX_WINDOW || (is_compare && stored(compare_reg))) {
+        return nullptr;
+    }
+
+    auto native = std::make_shared<NativeCode>();
+    native->cells = trace.computed.size();
+    native->window.assign(trace.inputs.rbegin(), trace.inputs.rend());
+    native->results = trace.stack;
+    native->registers = std::move(registers);
+    native->compare = is_compare;
+    native->compare_reg = compare_reg;
+    native->literals = trace.literals;
+
+    // The last values set by the macro, for each number of elements below its inputs
+    auto inputs = trace.inputs.size();
+    for(std::size_t below = 0; below <= Fold::MAX_DEPTH; below++) {
+        for(std::size_t pos = 0; pos < 3; pos++) {
+            NativeCode::LastValue last{NativeCode::LastValue::Source::KEEP, 0};
+            for(const auto &mark : trace.marks) {
+                auto [is_cell, index] = mark[pos];
+                if(is_cell) {
+                    last = {NativeCode::LastValue::Source::CELL, index};
+                } else if(index <= inputs) {
+                    last = {NativeCode::LastValue::Source::CELL, trace.inputs[index - 1]};
+                } else if(index - inputs <= below) {
+                    last = {NativeCode::LastValue::Source::STACK, index - inputs - 1};
+                }
+            }
+            native->last_values[below][pos] = last;
+        }
+    }
+
+    Assembler as;
+    // Prologue: push rbx; push r12; push r13; mov rbx, rdi; mov r12, rsi; mov r13d, edx
+    as.emit({0x53, 0x41, 0x54, 0x41, 0x55, 0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4, 0x41, 0x89, 0xD5});
+    for(const auto &op : trace.ops) {
+        native->integer_ops |= (op.kind == NativeOp::Kind::MOD);
+        emit_op(as, op, trace);
+    }
+    if(!is_compare) {
+        // xor eax, eax
+        as.emit({0x31, 0xC0});
+    }
+    as.finish();
+
+    if(!map_code(as.code, native->memory, native->size)) {
+        return nullptr;
+    }
+    native->entry = reinterpret_cast<NativeCode::Entry>(native->memory);
+
+    return native;
+#else
+    (void)program;
+
+    return nullptr;
+#endif
+}
+
+/**
+ * @brief Executes a macro in native code
+ *
+ * The values read by the macro are checked before entering the native code, which deoptimises when
+ * any of them is not a real number. A loop(i.e., a macro calling itself through its final comparison without
+ * changing the depth of the stack) is iterated in native code: the results of an iteration become the inputs of the
+ * next one. The stack, the registers and the last values are only updated when the macro returns or deoptimises. In
+ * the latter case, they are updated with the results of the last iteration that has been completed, so that the virtual
+ * machine resumes the loop from the iteration that has deoptimised.
+ *
+ * @param code The native code of the macro
+ * @param program The compiled macro
+ * @param body The source code of the macro
+ * @param stack An instance of the dc::Stack data structure
+ * @param regs An instance of the dc::RegisterFile data structure
+ * @param parameters An instance of the dc::Parameters data structure
+ * @param dc_macro The macro called by the final comparison, if any
+ *
+ * @return Whether the macro has been executed and whether it calls another macro
+ */
+JitStatus Jit::run(const NativeCode &code, const Program &program, const dc::SharedString &body,
+                   dc::Stack<dc::Value> &stack, dc::RegisterFile &regs, const dc::Parameters &parameters,
+                   dc::SharedString &dc_macro) {
+    // Empty registers are read as zero
+    static const dc::Value zero(0.0, 0);
+    auto inputs = code.window.size();
+    auto precision = parameters.precision;
+
+    // Integers are only accepted by the modulo operation when they have no decimal digits
+    if(parameters.iradix != 10 || stack.size() < inputs || (code.integer_ops && precision != 0)) {
+        return JitStatus::DEOPT;
+    }
+
+    std::array<double, MAX_CELLS> cells;
+    std::array<const dc::Value *, MAX_CELLS> origins;
+    // The first half of the flags tells whether the inputs are accepted by the modulo operation,
+    // the second half whether the cells have been rounded(see materialize)
+    std::array<std::uint8_t, 2 * MAX_CELLS> flags;
+    auto set_cell = [&](std::size_t cell, double number, const dc::Value *origin, bool rounded) {
+        cells[cell] = number;
+        origins[cell] = origin;
+        flags[MAX_CELLS + cell] = rounded;
+        if(code.integer_ops) {
+            flags[cell] = fits_long(number, origin, rounded);
+        }
+    };
+    auto cell_value = [&](std::size_t cell) {
+        return materialize(cells[cell], origins[cell], flags[MAX_CELLS + cell] != 0, precision);
+    };
+
+    std::fill_n(origins.begin(), code.cells, nullptr);
+    auto base = stack.size() - inputs;
+    for(std::size_t idx = 0; idx < inputs; idx++) {
+        const auto &value = stack[base + idx];
+        if(!value.is_number()) {
+            return JitStatus::DEOPT;
+        }
+        set_cell(code.window[idx], value.to_double(), &value, false);
+    }
+
+    for(const auto &[cell, literal] : code.literals) {
+        const auto &value = program.literals[literal];
+        set_cell(cell, value.to_double(), &value, false);
+    }
+
+    for(const auto &slot : code.registers) {
+        if(!slot.loaded) {
+            continue;
+        }
+
+        auto *reg = regs.find(slot.reg);
+        if(reg == nullptr || reg->stack.empty()) {
+            set_cell(slot.input, 0.0, &zero, false);
+        } else if(reg->stack.top().is_number()) {
+            set_cell(slot.input, reg->stack.top().to_double(), &reg->stack.top(), false);
+        } else {
+            return JitStatus::DEOPT;
+        }
+    }
+
+    dc::SharedString target;
+    auto loop = false;
+    if(code.compare) {
+        auto *reg = regs.find(code.compare_reg);
+        if(reg == nullptr || reg->stack.empty() || reg->stack.top().empty()) {
+            return JitStatus::DEOPT;
+        }
+        target = reg->stack.top().to_shared_string();
+        loop = (code.results.size() == inputs && target.view() == body.view());
+    }
+
+    /**
+     * @brief A last value set by the macro
+     */
+    struct LastValue {
+        NativeCode::LastValue::Source source = NativeCode::LastValue::Source::KEEP;
+        double number = 0.0;
+        const dc::Value *origin = nullptr;
+        bool rounded = false;
+        std::size_t index = 0;
+    };
+    std::array<LastValue, 3> last_values;
+    const auto &last_effect = code.last_values[std::min<std::size_t>(base, Fold::MAX_DEPTH)];
+
+    // Writes the results of the macro, whose cells are either the results of the
+    // last iteration or the inputs of the next one
+    auto commit = [&](const std::vector<std::size_t> &results, bool outputs) {
+        // Values are created before updating the stack and the registers, which they might be read from
+        alignas(dc::Value) std::array<std::byte, (2 * MAX_WINDOW + 3) * sizeof(dc::Value)> buffer;
+        std::pmr::monotonic_buffer_resource pool(buffer.data(), buffer.size());
+        std::pmr::vector<dc::Value> values(&pool);
+        values.reserve(results.size() + code.registers.size() + last_values.size());
+        for(auto cell : results) {
+            values.push_back(cell_value(cell));
+        }
+        for(const auto &slot : code.registers) {
+            auto cell = outputs ? slot.output : slot.input;
+            if(slot.stored) {
+                values.push_back(cell_value(cell));
+            }
+        }
+        for(const auto &last : last_values) {
+            if(last.source == NativeCode::LastValue::Source::CELL) {
+                values.push_back(materialize(last.number, last.origin, last.rounded, precision));
+            } else if(last.source == NativeCode::LastValue::Source::STACK) {
+                values.push_back(stack[base - 1 - last.index]);
+            }
+        }
+
+        auto value = values.begin();
+        for(std::size_t idx = 0; idx < inputs; idx++) {
+            stack.drop();
+        }
+        for(std::size_t idx = 0; idx < results.size(); idx++) {
+            stack.push(std::move(*value++));
+        }
+
+        for(const auto &slot : code.registers) {
+            if(!slot.stored) {
+                continue;
+            }
+
+            auto &reg_stack = regs[slot.reg].stack;
+            if(reg_stack.empty()) {
+                reg_stack.push(std::move(*value++));
+            } else {
+                reg_stack.set(reg_stack.size() - 1, std::move(*value++));
+            }
+        }
+
+        if(last_values[0].source != NativeCode::LastValue::Source::KEEP) {
+            stack.set_last_x(std::move(*value++));
+        }
+        if(last_values[1].source != NativeCode::LastValue::Source::KEEP) {
+            stack.set_last_y(std::move(*value++));
+        }
+        if(last_values[2].source != NativeCode::LastValue::Source::KEEP) {
+            stack.set_last_z(std::move(*value++));
+        }
+    };
+
+    auto iterated = false;
+    while(true) {
+        auto outcome = code.entry(cells.data(), flags.data(), precision);
+        if(outcome < 0) {
+            // Resume from the inputs of the iteration that has deoptimised
+            if(iterated) {
+                commit(code.window, false);
+            }
+
+            return JitStatus::DEOPT;
+        }
+
+        for(std::size_t pos = 0; pos < last_values.size(); pos++) {
+            const auto &effect = last_effect[pos];
+            if(effect.source == NativeCode::LastValue::Source::CELL) {
+                last_values[pos] = {effect.source, cells[effect.index], origins[effect.index],
+                                    flags[MAX_CELLS + effect.index] != 0, 0};
+            } else if(effect.source == NativeCode::LastValue::Source::STACK) {
+                last_values[pos] = {effect.source, 0.0, nullptr, false, effect.index};
+            }
+        }
+
+        if(outcome == 0 || !loop) {
+            commit(code.results, true);
+            if(outcome == 0) {
+                return JitStatus::RETURN;
+            }
+            dc_macro = std::move(target);
+
+            return JitStatus::CALL;
+        }
+
+        // The results of the iteration become the inputs of the next one. Since
+        // results can be inputs as well, they are copied before being moved
+        struct Cell {
+            double number;
+            const dc::Value *origin;
+            bool rounded;
+        };
+        std::array<Cell, 2 * MAX_WINDOW> next;
+        auto read_cell = [&](std::size_t cell) {
+            return Cell{cells[cell], origins[cell], flags[MAX_CELLS + cell] != 0};
+        };
+        for(std::size_t idx = 0; idx < inputs; idx++) {
+            next[idx] = read_cell(code.results[idx]);
+        }
+        for(std::size_t idx = 0; idx < code.registers.size(); idx++) {
+            next[inputs + idx] = read_cell(code.registers[idx].output);
+        }
+        for(std::size_t idx = 0; idx < inputs; idx++) {
+            set_cell(code.window[idx], next[idx].number, next[idx].origin, next[idx].rounded);
+        }
+        for(std::size_t idx = 0; idx < code.registers.size(); idx++) {
+            const auto &cell = next[inputs + idx];
+            set_cell(code.registers[idx].input, cell.number, cell.origin, cell.rounded);
+        }
+        iterated = true;
+    }
+}
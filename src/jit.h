@@ -0,0 +1,107 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "adt.h"
+#include "register_file.h"
+#include "compiler.h"
+
+/**
+ * @brief Outcome of the execution of a macro in native code
+ */
+enum class JitStatus : std::uint8_t {
+    DEOPT,      // The macro must be executed by the virtual machine
+    RETURN,     // The macro has been executed
+    CALL        // The macro has been executed and its final comparison yields a macro to be called
+};
+
+/**
+ * @brief Native x86-64 code of a purely numeric macro
+ *
+ * Data movement(i.e., d, r, R, lX and sX) is resolved when the macro is compiled: each value of the macro
+ * gets a cell and the machine code only computes the arithmetic, reading and writing cells. The stack, the
+ * registers and the last values are updated by Jit::run once the macro has been executed, thus the machine code
+ * can bail out at any point without side effects.
+ *
+ * The code lives in its own pages, which are mapped writable, filled and then made executable.
+ */
+class NativeCode {
+public:
+    NativeCode() = default;
+    NativeCode(const NativeCode&) = delete;
+    NativeCode &operator=(const NativeCode&) = delete;
+    ~NativeCode();
+
+private:
+    friend class Jit;
+
+    // Returns -1 to deoptimise, otherwise the outcome of the final comparison
+    using Entry = int (*)(double *cells, std::uint8_t *flags, unsigned int precision);
+
+    /**
+     * @brief The effect of the macro on a last value, see Fold::LastValue
+     */
+    struct LastValue {
+        enum class Source : std::uint8_t { KEEP, CELL, STACK };
+
+        Source source;
+        std::size_t index;      // A cell, or an element below the window counting from the head
+    };
+
+    /**
+     * @brief A register read or written by the macro
+     */
+    struct RegisterSlot {
+        char reg;
+        bool loaded;            // Whether the macro reads the register before writing it
+        bool stored;
+        std::size_t input;      // The cell holding the value of the register when the macro is entered
+        std::size_t output;     // The cell holding the value of the register when the macro returns
+    };
+
+    void *memory = nullptr;
+    std::size_t size = 0;
+    Entry entry = nullptr;
+
+    std::size_t cells = 0;
+    std::vector<std::size_t> window;        // Cells of the elements the macro consumes, from the bottom
+    std::vector<std::size_t> results;       // Cells of the elements the macro leaves, from the bottom
+    std::vector<std::pair<std::size_t, std::uint32_t>> literals;
+    std::vector<RegisterSlot> registers;
+    std::array<std::array<LastValue, 3>, Fold::MAX_DEPTH + 1> last_values{};
+    bool integer_ops = false;
+    bool compare = false;
+    char compare_reg = 0;
+};
+
+/**
+ * @brief Just-in-time compiler of purely numeric macros
+ *
+ * A macro made only of numbers, arithmetic(i.e., +, -, *, /, % and v), stack shuffling, register loads and stores and
+ * at most a final comparison is compiled into native code when it enters the macro cache. The code speculates that every
+ * value it reads is a real number: Jit::run checks the values when the macro is called and deoptimises(i.e., leaves the
+ * macro to the virtual machine) if any of them is not. The code deoptimises as well when an operation would not yield
+ * a real number or would raise an error(e.g., division by zero), so that the error is raised by the virtual machine.
+ * Loops, that is, macros calling themselves through the final comparison without changing the depth of the stack,
+ * are iterated in native code.
+ *
+ * This class is **not** meant to be instantiated
+ */
+class Jit {
+public:
+    Jit() = delete;
+    static void set_enabled(bool enabled);
+    static bool is_enabled();
+    static std::shared_ptr<const NativeCode> compile(const Program &program);
+    static JitStatus run(const NativeCode &code, const Program &program, const dc::SharedString &body,
+                         dc::Stack<dc::Value> &stack, dc::RegisterFile &regs, const dc::Parameters &parameters,
+                         dc::SharedString &dc_macro);
+
+    // Largest number of cells of a compiled macro
+    static constexpr std::size_t MAX_CELLS = 256;
+    // Largest number of elements a compiled macro consumes or leaves onto the stack
+    static constexpr std::size_t MAX_WINDOW = 16;
+};
@@ -0,0 +1,219 @@
+#include <algorithm>
+
+#include "lexer.h"
+#include "environment.h"
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static bool is_decimal_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Uppercase letters are digits of non decimal input bases
+static bool is_digit(char c) {
+    return is_decimal_digit(c) || (c >= 'A' && c <= 'F');
+}
+
+/**
+ * @brief Extracts the next token from the source code
+ * @return The next token, std::nullopt at the end of the source code
+ */
+std::optional<Token> Lexer::next() {
+    skip_blanks();
+    if(this->pos == this->source.size()) {
+        return std::nullopt;
+    }
+
+    return scan();
+}
+
+/**
+ * @brief Extracts the next statement from the source code
+ *
+ * A statement is a sequence of tokens that ends at the first newline that is not part of a string,
+ * thus a string(i.e., the body of a macro) can span multiple lines. Comments and empty lines
+ * are skipped
+ *
+ * @return The source code of the statement, std::nullopt at the end of the source code
+ */
+std::optional<std::string_view> Lexer::next_statement() {
+    skip_blanks();
+    if(this->pos == this->source.size()) {
+        return std::nullopt;
+    }
+
+    auto begin = this->pos;
+    std::size_t end;
+    do {
+        scan();
+        end = this->pos;
+    } while(!skip_blanks() && this->pos < this->source.size());
+
+    return this->source.substr(begin, end - begin);
+}
+
+/**
+ * @brief Skips whitespaces and comments, that is, '#' up to the end of the line
+ * @return true if a newline has been skipped, false otherwise
+ */
+bool Lexer::skip_blanks() {
+    bool newline = false;
+    while(this->pos < this->source.size()) {
+        auto c = this->source[this->pos];
+        if(c == '#') {
+            auto eol = this->source.find('\n', this->pos);
+            this->pos = (eol == std::string_view::npos) ? this->source.size() : eol;
+        } else if(is_space(c)) {
+            newline = newline || c == '\n';
+            this->pos++;
+        } else {
+            break;
+        }
+    }
+
+    return newline;
+}
+
+/**
+ * @brief Scans the token at the current position
+ * @return The token
+ */
+Token Lexer::scan() {
+    if(this->source[this->pos] == '[') {
+        return scan_macro();
+    }
+
+    // Unknown characters are returned on their own, the compiler
+    // treats them as literals
+    auto length = std::max({scan_number(), scan_command(), scan_register_command(), std::size_t{1}});
+    Token token{Token::Kind::WORD, this->source.substr(this->pos, length)};
+    this->pos += length;
+
+    return token;
+}
+
+/**
+ * @brief Computes the length of the number at the current position
+ *
+ * A number is made of digits, an optional decimal point and an optional exponent.
+ * The sign is part of the number only at the beginning of a word(e.g., "-5" but not "3-5")
+ *
+ * @return The length of the number, 0 if there is no number
+ */
+std::size_t Lexer::scan_number() const {
+    auto idx = this->pos;
+    auto at_word_start = (idx == 0 || is_space(this->source[idx - 1]));
+    if(at_word_start && (this->source[idx] == '+' || this->source[idx] == '-')) {
+        idx++;
+    }
+
+    bool found_digit = false, found_dec = false;
+    for(; idx < this->source.size(); idx++) {
+        auto c = this->source[idx];
+        if(is_digit(c)) {
+            found_digit = true;
+        } else if(c == '.' && !found_dec) {
+            found_dec = true;
+        } else {
+            break;
+        }
+    }
+
+    if(!found_digit) {
+        return 0;
+    }
+
+    // The exponent must be followed by at least one digit, otherwise 'e' is a command
+    if(idx < this->source.size() && this->source[idx] == 'e') {
+        auto exp = idx + 1;
+        if(exp < this->source.size() && (this->source[exp] == '+' || this->source[exp] == '-')) {
+            exp++;
+        }
+
+        if(exp < this->source.size() && is_decimal_digit(this->source[exp])) {
+            idx = exp;
+            while(idx < this->source.size() && is_decimal_digit(this->source[idx])) {
+                idx++;
+            }
+        }
+    }
+
+    return idx - this->pos;
+}
+
+/**
+ * @brief Computes the length of the longest command at the current position
+ * @return The length of the command, 0 if there is no command
+ */
+std::size_t Lexer::scan_command() const {
+    auto max_len = std::min(Environment::MAX_COMMAND_LEN, this->source.size() - this->pos);
+    for(auto len = max_len; len > 0; len--) {
+        if(Environment::find(this->source.substr(this->pos, len)) != std::nullopt) {
+            return len;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Computes the length of the register or comparison command at the current position
+ *
+ * Register commands(e.g., "sX", ":X") and comparison commands(e.g., ">X", "!=X") are followed
+ * by the name of a register, which can be any non-whitespace character
+ *
+ * @return The length of the command, 0 if there is no register command
+ */
+std::size_t Lexer::scan_register_command() const {
+    switch(this->source[this->pos]) {
+        case 's': case 'S': case 'l': case 'L':
+        case 'c': case 'z': case ':': case ';':
+        case '=':
+            return has_operand(1) ? 2 : 0;
+        case '<': case '>':
+            if(this->source.substr(this->pos + 1, 1) == "=" && has_operand(2)) {
+                return 3;
+            }
+            return has_operand(1) ? 2 : 0;
+        case '!':
+            return (this->source.substr(this->pos + 1, 1) == "=" && has_operand(2)) ? 3 : 0;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Checks whether a register name follows the current position
+ * @param offset The distance of the register name from the current position
+ * @return true if there is a register name, false otherwise
+ */
+bool Lexer::has_operand(std::size_t offset) const {
+    return this->pos + offset < this->source.size() && !is_space(this->source[this->pos + offset]);
+}
+
+/**
+ * @brief Scans a string, from the opening bracket to the matching closing one
+ *
+ * Nested strings are part of the enclosing one
+ *
+ * @return The content of the string
+ */
+Token Lexer::scan_macro() {
+    auto begin = ++this->pos;
+    std::size_t brackets_count = 1;
+
+    for(; this->pos < this->source.size(); this->pos++) {
+        if(this->source[this->pos] == '[') {
+            brackets_count++;
+        } else if(this->source[this->pos] == ']' && --brackets_count == 0) {
+            Token token{Token::Kind::MACRO, this->source.substr(begin, this->pos - begin)};
+            this->pos++;
+
+            return token;
+        }
+    }
+
+    return Token{Token::Kind::UNBALANCED, this->source.substr(begin)};
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <string_view>
+#include <optional>
+#include <cstdint>
+
+/**
+ * @brief A token of a DC program
+ *
+ * The text of a token is a view over the source code, thus a token is only
+ * valid as long as the source code it has been extracted from
+ */
+struct Token {
+    enum class Kind : std::uint8_t {
+        WORD,       // A command, a register command or a literal
+        MACRO,      // The content of a [...] string, without brackets
+        UNBALANCED  // A string missing its closing bracket
+    };
+
+    Kind kind;
+    std::string_view text;
+};
+
+/**
+ * @brief Single pass scanner of DC source code
+ *
+ * Splits the source code into tokens without copying it. Tokens do not need to be
+ * separated by whitespaces: adjacent commands(e.g., "2 3+p"), register commands(e.g., "sX", "lX")
+ * and strings(e.g., "[...]") are recognized on their own. When two tokens start at the same
+ * position, the longest one wins, so that whitespace separated programs keep their meaning.
+ * Comments start with '#' and end at the end of the line, except within strings
+ */
+class Lexer {
+public:
+    /**
+     * @brief Constructor of Lexer
+     * @param src The source code to be scanned
+     */
+    explicit Lexer(std::string_view src) : source(src) {}
+    std::optional<Token> next();
+    std::optional<std::string_view> next_statement();
+
+private:
+    bool skip_blanks();
+    Token scan();
+    [[nodiscard]] std::size_t scan_number() const;
+    [[nodiscard]] std::size_t scan_command() const;
+    [[nodiscard]] std::size_t scan_register_command() const;
+    [[nodiscard]] bool has_operand(std::size_t offset) const;
+    Token scan_macro();
+
+    std::string_view source;
+    std::size_t pos = 0;
+};
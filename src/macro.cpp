@@ -1,16 +1,19 @@
 #include <iostream>
-#include <sstream>
-#include <iterator>
 #include <limits>
-#include <fstream>
 
 #include "adt.cpp"
 #include "eval.h"
 #include "macro.h"
-#include "num_utils.h"
+#include "macro_cache.h"
+#include "arena.h"
+#include "script.h"
+#include "output.h"
 
-std::optional<std::string> Macro::exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
-    std::optional<std::string> err = std::nullopt;
+// Source of the lines read by '?', the standard input when empty
+static std::function<bool(std::string&)> input_reader;
+
+std::optional<dc::Error> Macro::exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) {
+    std::optional<dc::Error> err = std::nullopt;
 
     switch(this->op_type) {
         case OPType::EX: err = fn_execute(stack, parameters, regs); break;
@@ -31,32 +34,19 @@ std::optional<std::string> Macro::exec(dc::Stack<std::string> &stack, dc::Parame
  * 
  * @param stack An instance of dc::Stack
  * @param parameters An instance of dc::Parameters
- * @param regs An instance of the dc::Register
+ * @param regs An instance of the dc::RegisterFile
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Macro::fn_execute(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "This operation does not work on empty stack";
-    }
+std::optional<dc::Error> Macro::fn_execute(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) {
+    dc::SharedString dc_macro;
 
-    // If the head of the stack is a string
-    // pop it and execute it as a macro
-    auto head = stack.pop(false);
-    if(!NumericUtils::is_numeric<double>(head)) {
-        stack.copy_xyz();
-        stack.pop(true);
-        std::vector<std::string> tokens = split(head);
-        Evaluate evaluator(tokens, regs, stack, parameters);
-        
-        auto err = evaluator.eval();
-        if(err != std::nullopt) {
-            return err;
-        }
+    auto err = fetch_macro(stack, dc_macro);
+    if(err != std::nullopt || dc_macro.empty()) {
+        return err;
     }
 
-    return std::nullopt;
+    return run(dc_macro, stack, parameters, regs);
 }
 
 /**
@@ -68,111 +58,121 @@ std::optional<std::string> Macro::fn_execute(dc::Stack<std::string> &stack, dc::
  * 
  * @param stack An instance of dc::Stack
  * @param parameters An instance of dc::Parameters
- * @param regs An instance of the dc::Register
+ * @param regs An instance of the dc::RegisterFile
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Macro::fn_evaluate_macro(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
+std::optional<dc::Error> Macro::fn_evaluate_macro(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) {
+    dc::SharedString dc_macro;
+
+    auto err = fetch_comparison(this->op, this->dc_register, stack, regs, dc_macro);
+    if(err != std::nullopt || dc_macro.empty()) {
+        return err;
+    }
+
+    return run(dc_macro, stack, parameters, regs);
+}
+
+/**
+ * @brief Fetches the macro to be executed by the 'x' command
+ *
+ * Takes one value from the stack and returns it as a macro if it is a string. If the value
+ * is a number, leaves it onto the stack. This method does not execute the macro, allowing
+ * the caller to decide how to run it(e.g., the virtual machine schedules it on its own frame stack)
+ *
+ * @param stack An instance of dc::Stack
+ * @param dc_macro The macro to be executed, empty if there is nothing to execute
+ *
+ * @return Evaluation errors, if any
+ */
+std::optional<dc::Error> Macro::fetch_macro(dc::Stack<dc::Value> &stack, dc::SharedString &dc_macro) {
+    // Check if stack has enough elements
+    if(stack.empty()) {
+        return dc::Error(dc::ErrorCode::EMPTY_STACK);
+    }
+
+    // If the head of the stack is a string
+    // pop it and execute it as a macro
+    if(!stack[stack.size() - 1].is_number()) {
+        stack.copy_xyz();
+        dc_macro = stack.pop(true).to_shared_string();
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Fetches the macro to be executed by a comparison command
+ *
+ * Takes two values from the stack and compares them. If the comparison holds,
+ * returns the content of the register as the macro to be executed. Like Macro::fetch_macro,
+ * this method does not execute the macro
+ *
+ * @param op The type of comparison operation
+ * @param dc_register The name of the register to call when the comparison yields true
+ * @param stack An instance of dc::Stack
+ * @param regs An instance of the dc::RegisterFile
+ * @param dc_macro The macro to be executed, empty if there is nothing to execute
+ *
+ * @return Evaluation errors, if any
+ */
+std::optional<dc::Error> Macro::fetch_comparison(MacroOP op, char dc_register, dc::Stack<dc::Value> &stack, dc::RegisterFile &regs, dc::SharedString &dc_macro) {
     // Check whether the main stack has enough elements
     if(stack.size() < 2) {
-        return "This operation requires two elements";
+        return dc::Error(dc::ErrorCode::REQUIRES_TWO_ELEMENTS);
     }
 
     // Check whether the register's stack exists or not
-    if(regs.find(this->dc_register) == regs.end()) {
-        return "Null register";
+    auto *reg = regs.find(dc_register);
+    if(reg == nullptr) {
+        return dc::Error(dc::ErrorCode::NULL_REGISTER);
     }
 
     // Extract macro and top two values of the stack
     stack.copy_xyz();
-    auto head_str = stack.pop(true);
-    auto second_str = stack.pop(true);
-    auto dc_macro = regs[this->dc_register].stack.pop(false);
+    auto head_val = stack.pop(true);
+    auto second_val = stack.pop(true);
+
+    // A register whose stack has been emptied(e.g., by 'L') holds no macro
+    if(reg->stack.empty()) {
+        return std::nullopt;
+    }
+    const auto& reg_macro = reg->stack.top();
 
     // Check if macro exists and if top two elements of main stack are numbers
-    if(!dc_macro.empty() && NumericUtils::is_numeric<double>(head_str) && NumericUtils::is_numeric<double>(second_str)) {
-        auto head = std::stod(head_str);
-        auto second = std::stod(second_str);
-
-        switch(this->op) {
-            case MacroOP::GT: {
-                if(head > second) {
-                    std::vector<std::string> tokens = split(dc_macro);
-                    Evaluate evaluator(tokens, regs, stack, parameters);
-
-                    auto err = evaluator.eval();
-                    if(err != std::nullopt) {
-                        return err;
-                    }
-                }
-                break;
-            }
-            case MacroOP::LT: {
-                if(head < second) {
-                    std::vector<std::string> tokens = split(dc_macro);
-                    Evaluate evaluator(tokens, regs, stack, parameters);
-
-                    auto err = evaluator.eval();
-                    if(err != std::nullopt) {
-                        return err;
-                    }
-                }
-                break;
-            }
-            case MacroOP::EQ: {
-                if(head == second) {
-                    std::vector<std::string> tokens = split(dc_macro);
-                    Evaluate evaluator(tokens, regs, stack, parameters);
-
-                    auto err = evaluator.eval();
-                    if(err != std::nullopt) {
-                        return err;
-                    }
-                }
-                break;
-            }
-            case MacroOP::GEQ: {
-                if(head >= second) {
-                    std::vector<std::string> tokens = split(dc_macro);
-                    Evaluate evaluator(tokens, regs, stack, parameters);
-
-                    auto err = evaluator.eval();
-                    if(err != std::nullopt) {
-                        return err;
-                    }
-                }
-                break;
-            }
-            case MacroOP::LEQ: {
-                if(head <= second) {
-                    std::vector<std::string> tokens = split(dc_macro);
-                    Evaluate evaluator(tokens, regs, stack, parameters);
-
-                    auto err = evaluator.eval();
-                    if(err != std::nullopt) {
-                        return err;
-                    }
-                }
-                break;
-            }
-            case MacroOP::NEQ: {
-                if(head != second) {
-                    std::vector<std::string> tokens = split(dc_macro);
-                    Evaluate evaluator(tokens, regs, stack, parameters);
-
-                    auto err = evaluator.eval();
-                    if(err != std::nullopt) {
-                        return err;
-                    }
-                }
-                break;
-            }
+    if(!reg_macro.empty() && head_val.is_number() && second_val.is_number()) {
+        auto head = head_val.to_double();
+        auto second = second_val.to_double();
+
+        bool cond = false;
+
+        switch(op) {
+            case MacroOP::GT: cond = (head > second); break;
+            case MacroOP::LT: cond = (head < second); break;
+            case MacroOP::EQ: cond = (head == second); break;
+            case MacroOP::GEQ: cond = (head >= second); break;
+            case MacroOP::LEQ: cond = (head <= second); break;
+            case MacroOP::NEQ: cond = (head != second); break;
+        }
+
+        if(cond) {
+            dc_macro = reg_macro.to_shared_string();
         }
     }
 
     return std::nullopt;
 }
 
+/**
+ * @brief Sets the source of the lines read by '?'
+ *
+ * @param reader A function that reads the next line, returning false at the end of the input.
+ * An empty function restores the standard input
+ */
+void Macro::set_input(std::function<bool(std::string&)> reader) {
+    input_reader = std::move(reader);
+}
+
 /**
  * @brief Executes a macro from standard input
  * 
@@ -180,22 +180,23 @@ std::optional<std::string> Macro::fn_evaluate_macro(dc::Stack<std::string> &stac
  * 
  * @param stack An instance of dc::Stack
  * @param parameters An instance of dc::Parameters
- * @param regs An instance of the dc::Register
+ * @param regs An instance of the dc::RegisterFile
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Macro::fn_read_input(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
+std::optional<dc::Error> Macro::fn_read_input(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) {
     // Read user input from stdin
     std::string user_input;
 
-    std::getline(std::cin, user_input);
-    if(std::cin.fail()) {
-        return "Error while reading from stdin";
+    // Prompts must be visible before the input is read
+    dc::Output::instance().flush();
+    bool read = input_reader ? input_reader(user_input) : static_cast<bool>(std::getline(std::cin, user_input));
+    if(!read) {
+        return dc::Error(dc::ErrorCode::STDIN_ERROR);
     }
 
-    // Push the input onto the main stack and execute it as a macro
-    std::vector<std::string> tokens = split(user_input);
-    Evaluate evaluator(tokens, regs, stack, parameters);
+    // Execute the input as a macro
+    Evaluate evaluator(user_input, regs, stack, parameters);
         
     auto err = evaluator.eval();
     if(err != std::nullopt) {
@@ -208,77 +209,50 @@ std::optional<std::string> Macro::fn_read_input(dc::Stack<std::string> &stack, d
 /**
  * @brief Executes the content of a file
  * 
- * Takes a string from the stack and uses it as a filepath, then reads its content
- * and executes it as a macro
+ * Takes a string from the stack and uses it as a filepath, then maps its content
+ * and executes it statement by statement(see Script)
  * 
  * @param stack An instance of dc::Stack
  * @param parameters An instance of dc::Parameters
- * @param regs An instance of the dc::Register
+ * @param regs An instance of the dc::RegisterFile
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Macro::fn_evaluate_file(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
-    // Check whether the main stack has enough elements
-    if(stack.empty()) {
-        return "This operation does not work on empty stack";
-    }
-
+std::optional<dc::Error> Macro::fn_evaluate_file(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) {
     // If the head of the stack is a string,
-    auto file_name = stack.pop(false);
-    if(!NumericUtils::is_numeric<double>(file_name)) {
+    const auto& head = stack.top();
+    if(!head.is_number()) {
+        auto file_name = head.to_shared_string();
         // Pop it from the stack
         stack.copy_xyz();
-        stack.pop(true);
+        stack.drop();
         // And use it as a filename
-        std::fstream source_file(file_name, std::ios::in | std::ios::binary);
-        if(source_file.fail()) {
-            return std::string("Cannot open source file \"") + file_name + std::string("\"");
-        }
-        
-        // Read whole file into a buffer
-        std::stringstream buf;
-        buf << source_file.rdbuf();
-
-        // Execute file line by line
-        std::string line;
-        while(std::getline(buf, line, '\n')) {
-            // Ignore comments or empty lines
-            if(line.empty() || line.starts_with('#')) {
-                continue;
-            }
-
-            // Remove inline comments
-            auto comment_pos = line.find('#');
-            std::vector<std::string> tokens;
-
-            if(comment_pos != std::string::npos) {
-                // Convert only the first part of the line
-                tokens = split(line.substr(0, comment_pos));
-            } else {
-                // Otherwise split the whole string
-                tokens = split(line);
-            }
-
-            // Evaluate expression
-            Evaluate evaluator(tokens, regs, stack, parameters);
-            auto err = evaluator.eval();
-            // Handle errors
-            if(err != std::nullopt) {
-                return err;
-            }
+        Script script(std::string(file_name.view()));
+        if(!script.is_open()) {
+            return dc::Error(dc::ErrorCode::CANNOT_OPEN_FILE, std::move(file_name));
         }
+
+        // Execute file statement by statement. The programs of the statements
+        // live in an arena that is reset for each statement
+        dc::Arena arena;
+        return script.eval(regs, stack, parameters, arena);
     } else {
-        return "This operation requires string values";
+        return dc::Error(dc::ErrorCode::STRING_OPERANDS);
     }
-
-    return std::nullopt;
 }
 
-std::vector<std::string> Macro::split(const std::string& str) {
-    std::stringstream ss(str);
-    std::istream_iterator<std::string> begin(ss);
-    std::istream_iterator<std::string> end;
-    std::vector<std::string> vec(begin, end);
+/**
+ * @brief Executes a macro through the macro cache
+ *
+ * @param dc_macro The source code of the macro
+ * @param stack An instance of dc::Stack
+ * @param parameters An instance of dc::Parameters
+ * @param regs An instance of the dc::RegisterFile
+ *
+ * @return Evaluation errors, if any
+ */
+std::optional<dc::Error> Macro::run(const dc::SharedString &dc_macro, dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) {
+    Evaluate evaluator(MacroCache::instance().get(dc_macro, parameters), regs, stack, parameters);
 
-    return vec;
+    return evaluator.eval();
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include <string>
+#include <functional>
 
 #include "operation.h"
 
@@ -37,18 +39,21 @@ public:
      * 
      * @param stack An instance of the dc::Stack data structure
      * @param parameters An instance of the dc::Parameters data structure
-     * @param regs An instance of the dc::Register data structure
+     * @param regs An instance of the dc::RegisterFile data structure
      * 
      * @return Runtime errors, if any
      */
-    std::optional<std::string> exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) override;
-    static std::vector<std::string> split(const std::string& str);
+    std::optional<dc::Error> exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) override;
+    static std::optional<dc::Error> fetch_macro(dc::Stack<dc::Value> &stack, dc::SharedString &dc_macro);
+    static std::optional<dc::Error> fetch_comparison(MacroOP op, char dc_register, dc::Stack<dc::Value> &stack, dc::RegisterFile &regs, dc::SharedString &dc_macro);
+    static void set_input(std::function<bool(std::string&)> reader);
 
 private:
-    static std::optional<std::string> fn_execute(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
-    std::optional<std::string> fn_evaluate_macro(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
-    static std::optional<std::string> fn_read_input(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
-    static std::optional<std::string> fn_evaluate_file(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
+    static std::optional<dc::Error> fn_execute(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs);
+    std::optional<dc::Error> fn_evaluate_macro(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs);
+    static std::optional<dc::Error> fn_read_input(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs);
+    static std::optional<dc::Error> fn_evaluate_file(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs);
+    static std::optional<dc::Error> run(const dc::SharedString &dc_macro, dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs);
 
     OPType op_type;
     MacroOP op{};
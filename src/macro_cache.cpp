@@ -0,0 +1,89 @@
+#include "macro_cache.h"
+#include "jit.h"
+
+/**
+ * @brief Gets the process-wide instance of the macro cache
+ * @return A reference to the macro cache
+ */
+MacroCache &MacroCache::instance() {
+    static MacroCache cache;
+
+    return cache;
+}
+
+/**
+ * @brief Retrieves the compiled program of a macro
+ *
+ * If the macro is not cached, compiles it(into native code as well, if the JIT is enabled)
+ * and stores it into the cache, possibly evicting the least recently used macro
+ *
+ * @param body The source code of the macro
+ * @param parameters The parameters a new macro is compiled with
+ * @return The compiled macro
+ */
+std::shared_ptr<const Program> MacroCache::get(const dc::SharedString &body, const dc::Parameters &parameters) {
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        auto it = this->index.find(body.view());
+        if(it != this->index.end()) {
+            // Move the entry to the front of the LRU list
+            this->lru.splice(this->lru.begin(), this->lru, it->second);
+            this->hits++;
+
+            return it->second->program;
+        }
+        this->misses++;
+    }
+
+    // Compile the macro without holding the lock
+    auto compiled = Compiler::compile(body, parameters);
+    if(Jit::is_enabled()) {
+        compiled.native = Jit::compile(compiled);
+    }
+    auto program = std::make_shared<const Program>(std::move(compiled));
+
+    std::lock_guard<std::mutex> lock(this->mtx);
+    if(this->capacity == 0 || this->index.contains(body.view())) {
+        return program;
+    }
+
+    // Evict the least recently used macro if the cache is full
+    if(this->index.size() >= this->capacity) {
+        this->index.erase(this->lru.back().body.view());
+        this->lru.pop_back();
+        this->evictions++;
+    }
+
+    this->lru.push_front(Entry{body, program});
+    this->index.emplace(this->lru.front().body.view(), this->lru.begin());
+
+    return program;
+}
+
+/**
+ * @brief Retrieves the counters of the cache
+ * @return The number of hits, misses, evictions and the size of the cache
+ */
+MacroCacheStats MacroCache::stats() {
+    std::lock_guard<std::mutex> lock(this->mtx);
+
+    return MacroCacheStats{this->hits, this->misses, this->evictions, this->index.size()};
+}
+
+/**
+ * @brief Sets the maximum number of cached macros
+ *
+ * A capacity of zero disables the cache
+ *
+ * @param cap The new capacity
+ */
+void MacroCache::set_capacity(std::size_t cap) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    this->capacity = cap;
+
+    while(this->index.size() > this->capacity) {
+        this->index.erase(this->lru.back().body.view());
+        this->lru.pop_back();
+        this->evictions++;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+#include "compiler.h"
+
+/**
+ * @brief Hit/miss counters of the macro cache
+ */
+struct MacroCacheStats {
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t evictions;
+    std::size_t size;
+};
+
+/**
+ * @brief Process-wide cache of compiled macros
+ *
+ * Maps the body of a macro to its compiled program, so that a macro executed
+ * multiple times(e.g., the body of a loop) is tokenized and compiled only once.
+ * The cache has a bounded size and evicts the least recently used macros first.
+ * Compiled programs are immutable and reference counted, therefore an evicted
+ * program stays valid for as long as an evaluator is executing it.
+ */
+class MacroCache {
+public:
+    static MacroCache &instance();
+    std::shared_ptr<const Program> get(const dc::SharedString &body, const dc::Parameters &parameters);
+    [[nodiscard]] MacroCacheStats stats();
+    void set_capacity(std::size_t cap);
+
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+private:
+    MacroCache() = default;
+
+    struct Entry {
+        dc::SharedString body;
+        std::shared_ptr<const Program> program;
+    };
+
+    std::list<Entry> lru;
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+    std::size_t capacity = DEFAULT_CAPACITY;
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::mutex mtx;
+};
@@ -6,10 +6,9 @@
 
 #include "adt.cpp"
 #include "mathematics.h"
-#include "num_utils.h"
 
-std::optional<std::string> Mathematics::exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, __attribute__((unused))  std::unordered_map<char, dc::Register> &regs) {
-    std::optional<std::string> err = std::nullopt;
+std::optional<dc::Error> Mathematics::exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, __attribute__((unused))  dc::RegisterFile &regs) {
+    std::optional<dc::Error> err = std::nullopt;
 
     switch(this->op_type) {
         case OPType::ADD: err = fn_add(stack, parameters); break;
@@ -52,48 +51,36 @@ std::optional<std::string> Mathematics::exec(dc::Stack<std::string> &stack, dc::
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_add(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'+' requires two operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_add(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
-    auto is_x_cmplx = is_complex(x);
-    auto is_y_cmplx = is_complex(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
+    auto is_x_cmplx = x.is_complex();
+    auto is_y_cmplx = y.is_complex();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        auto rhs = std::stod(stack.pop(true));
-        auto lhs = std::stod(stack.pop(true));
+        auto rhs = stack.pop(true).to_double();
+        auto lhs = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number((lhs + rhs), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value((lhs + rhs), parameters.precision));
     } else if(is_x_cmplx || is_y_cmplx) {
         stack.copy_xyz();
         // Convert complex dc objects(ie strings) to std::complex
-        std::complex<double> rhs, lhs;
-        std::istringstream ss1(stack.pop(true));
-        std::istringstream ss2(stack.pop(true));
-        ss1 >> rhs, ss2 >> lhs;
+        auto rhs = stack.pop(true).to_complex();
+        auto lhs = stack.pop(true).to_complex();
 
         std::complex<double> sum = (rhs + lhs);
 
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(sum.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(sum.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(sum, parameters.precision));
     } else {
-        return "'+' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "+");
     }
 
     return std::nullopt;
@@ -110,26 +97,21 @@ std::optional<std::string> Mathematics::fn_add(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_sub(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'-' requires two operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_sub(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
-    auto is_x_cmplx = is_complex(x);
-    auto is_y_cmplx = is_complex(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
+    auto is_x_cmplx = x.is_complex();
+    auto is_y_cmplx = y.is_complex();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        auto rhs = std::stod(stack.pop(true));
-        auto lhs = std::stod(stack.pop(true));
+        auto rhs = stack.pop(true).to_double();
+        auto lhs = stack.pop(true).to_double();
 
         // Subtract the two operands
         auto result = (lhs - rhs);
@@ -141,27 +123,20 @@ std::optional<std::string> Mathematics::fn_sub(dc::Stack<std::string> &stack, co
             result = 0.0;
         }
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(result, parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(result, parameters.precision));
     } else if(is_x_cmplx || is_y_cmplx) {
         stack.copy_xyz();
         // Convert complex dc objects(ie strings) to std::complex
-        std::complex<double> rhs, lhs;
-        std::istringstream ss1(stack.pop(true));
-        std::istringstream ss2(stack.pop(true));
-        ss1 >> rhs, ss2 >> lhs;
+        auto rhs = stack.pop(true).to_complex();
+        auto lhs = stack.pop(true).to_complex();
 
         std::complex<double> diff = (lhs - rhs);
 
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(diff.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(diff.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(diff, parameters.precision));
     } else {
-        return "'-' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "-");
     }
 
     return std::nullopt;
@@ -178,48 +153,36 @@ std::optional<std::string> Mathematics::fn_sub(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_mul(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'*' requires two operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_mul(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
-    auto is_x_cmplx = is_complex(x);
-    auto is_y_cmplx = is_complex(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
+    auto is_x_cmplx = x.is_complex();
+    auto is_y_cmplx = y.is_complex();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        auto rhs = std::stod(stack.pop(true));
-        auto lhs = std::stod(stack.pop(true));
+        auto rhs = stack.pop(true).to_double();
+        auto lhs = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number((lhs * rhs), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value((lhs * rhs), parameters.precision));
     } else if(is_x_cmplx || is_y_cmplx) {
         stack.copy_xyz();
         // Convert complex dc objects(ie strings) to std::complex
-        std::complex<double> rhs, lhs;
-        std::istringstream ss1(stack.pop(true));
-        std::istringstream ss2(stack.pop(true));
-        ss1 >> rhs, ss2 >> lhs;
+        auto rhs = stack.pop(true).to_complex();
+        auto lhs = stack.pop(true).to_complex();
 
         std::complex<double> mul = (lhs * rhs);
 
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(mul.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(mul.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(mul, parameters.precision));
     } else {
-        return "'*' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "*");
     }
 
     return std::nullopt;
@@ -236,58 +199,46 @@ std::optional<std::string> Mathematics::fn_mul(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_div(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'/' requires two operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_div(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
-    auto is_x_cmplx = is_complex(x);
-    auto is_y_cmplx = is_complex(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
+    auto is_x_cmplx = x.is_complex();
+    auto is_y_cmplx = y.is_complex();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        auto divisor = std::stod(stack.pop(true));
-        auto dividend = std::stod(stack.pop(true));
+        auto divisor = stack.pop(true).to_double();
+        auto dividend = stack.pop(true).to_double();
 
         // Check whether divisor is equal to zero
         if(divisor == 0.0) {
-            return "Cannot divide by zero";
+            return dc::Error(dc::ErrorCode::DIVISION_BY_ZERO);
         }
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number((dividend / divisor), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value((dividend / divisor), parameters.precision));
     } else if(is_x_cmplx || is_y_cmplx) {
         stack.copy_xyz();
         // Convert complex dc objects(ie strings) to std::complex
-        std::complex<double> divisor, dividend;
-        std::istringstream ss1(stack.pop(true));
-        std::istringstream ss2(stack.pop(true));
-        ss1 >> divisor, ss2 >> dividend;
+        auto divisor = stack.pop(true).to_complex();
+        auto dividend = stack.pop(true).to_complex();
 
         // Check whether divisor is equal to zero
         if(divisor == 0.0) {
-            return "Cannot divide by zero";
+            return dc::Error(dc::ErrorCode::DIVISION_BY_ZERO);
         }
 
         std::complex<double> div = (dividend / divisor);
 
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(div.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(div.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(div, parameters.precision));
     } else {
-        return "'/' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "/");
     }
 
     return std::nullopt;
@@ -304,34 +255,29 @@ std::optional<std::string> Mathematics::fn_div(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_mod(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'%' requires two operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_mod(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<long long>(x);
-    auto is_y_num = NumericUtils::is_numeric<long long>(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_long();
+    auto is_y_num = y.is_long();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        auto rhs = std::stoll(stack.pop(true));
-        auto lhs = std::stoll(stack.pop(true));
+        auto rhs = stack.pop(true).to_long();
+        auto lhs = stack.pop(true).to_long();
 
         // Check whether divisor is equal to zero
         if(rhs == 0) {
-            return "Cannot divide by zero";
+            return dc::Error(dc::ErrorCode::DIVISION_BY_ZERO);
         }
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number((lhs % rhs), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value((lhs % rhs), parameters.precision));
     } else {
-        return "'%' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "%");
     }
 
     return std::nullopt;
@@ -348,36 +294,31 @@ std::optional<std::string> Mathematics::fn_mod(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_div_mod(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'~' requires two operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_div_mod(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        auto divisor = std::stod(stack.pop(true));
-        auto dividend = std::stod(stack.pop(true));
+        auto divisor = stack.pop(true).to_double();
+        auto dividend = stack.pop(true).to_double();
 
         // Check if divisor is not equal to zero
         if(divisor != 0.0) {
             auto quotient = std::trunc(dividend / divisor);
             auto remainder = ((int)dividend % (int)divisor);
 
-            stack.push(NumericUtils::format_number(quotient, parameters.precision));
-            stack.push(NumericUtils::format_number(remainder, parameters.precision));
+            stack.push(dc::Value(quotient, parameters.precision));
+            stack.push(dc::Value(remainder, parameters.precision));
         }
 
     } else {
-        return "'~' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "~");
     }
 
     return std::nullopt;
@@ -395,40 +336,35 @@ std::optional<std::string> Mathematics::fn_div_mod(dc::Stack<std::string> &stack
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_mod_exp(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 3) {
-        return "'|' requires three operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_mod_exp(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Otherwise extract three elements from the stack.
 	// The first one is the modulus(n), the second one
 	// is the exponent(e) and the third one is the base(b)
     auto len = stack.size()-1;
-    auto n = stack[len];
-    auto e = stack[len-1];
-    auto b = stack[len-2];
-    auto is_n_num = NumericUtils::is_numeric<long long>(n);
-    auto is_e_num = NumericUtils::is_numeric<long long>(e);
-    auto is_b_num = NumericUtils::is_numeric<long long>(b);
+    const auto& n = stack[len];
+    const auto& e = stack[len-1];
+    const auto& b = stack[len-2];
+    auto is_n_num = n.is_long();
+    auto is_e_num = e.is_long();
+    auto is_b_num = b.is_long();
 
     // This functions computes
 	// 		c ≡ b^e (mod n)
     if(is_n_num && is_e_num && is_b_num) {
         stack.copy_xyz();
-        auto modulus = std::stoll(stack.pop(true));
-        auto exponent = std::stoll(stack.pop(true));
-        auto base = std::stoll(stack.pop(true));
+        auto modulus = stack.pop(true).to_long();
+        auto exponent = stack.pop(true).to_long();
+        auto base = stack.pop(true).to_long();
 
         if(modulus == 1) {
-            stack.push("0");
+            stack.push(dc::Value(0.0, 0));
             return std::nullopt;
         } else if(modulus == 0) {
-            return "Modulus cannot be zero";
+            return dc::Error(dc::ErrorCode::ZERO_MODULUS);
         }
 
         if(exponent < 0) {
-            return "Exponent cannot be negative";
+            return dc::Error(dc::ErrorCode::NEGATIVE_EXPONENT);
         }
 
         auto c = 1;
@@ -436,9 +372,9 @@ std::optional<std::string> Mathematics::fn_mod_exp(dc::Stack<std::string> &stack
             c = (c * base) % modulus;
         }
         
-        stack.push(NumericUtils::format_number(c, parameters.precision));
+        stack.push(dc::Value(c, parameters.precision));
     } else {
-        return "'|' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "|");
     }
 
     return std::nullopt;
@@ -455,26 +391,21 @@ std::optional<std::string> Mathematics::fn_mod_exp(dc::Stack<std::string> &stack
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_exp(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'^' requires two operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_exp(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto y = stack[len-1];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
-    auto is_x_cmplx = is_complex(x);
-    auto is_y_cmplx = is_complex(y);
+    const auto& x = stack[len];
+    const auto& y = stack[len-1];
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
+    auto is_x_cmplx = x.is_complex();
+    auto is_y_cmplx = y.is_complex();
 
     // Check whether both entries are numbers
     if(is_x_num && is_y_num) {
         stack.copy_xyz();
-        auto exp = std::stod(stack.pop(true));
-        auto base = std::stod(stack.pop(true));
+        auto exp = stack.pop(true).to_double();
+        auto base = stack.pop(true).to_double();
 
         std::complex<double> power;
 
@@ -489,36 +420,24 @@ std::optional<std::string> Mathematics::fn_exp(dc::Stack<std::string> &stack, co
 
         // Check if result is a complex number
         if(std::imag(power) != 0) {
-            // trim their digits
-            auto real_trimmed = NumericUtils::format_number(power.real(), parameters.precision);
-            auto imag_trimmed = NumericUtils::format_number(power.imag(), parameters.precision);
-            auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
             // Push the result back onto the stack
-            stack.push(complex_str);
+            stack.push(dc::Value(power, parameters.precision));
         } else {
             // Push the result back onto the stack
-            stack.push(NumericUtils::format_number(std::real(power), parameters.precision));
+            stack.push(dc::Value(std::real(power), parameters.precision));
         }
     } else if(is_x_cmplx || is_y_cmplx) {
         stack.copy_xyz();
         // Convert complex dc objects(ie strings) to std::complex
-        std::complex<double> exp, base;
-        std::istringstream ss1(stack.pop(true));
-        std::istringstream ss2(stack.pop(true));
-        ss1 >> exp, ss2 >> base;
+        auto exp = stack.pop(true).to_complex();
+        auto base = stack.pop(true).to_complex();
 
         std::complex<double> power = std::pow(base, exp);
 
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(power.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(power.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(power, parameters.precision));
     } else {
-        return "'^' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "^");
     }
 
     return std::nullopt;
@@ -534,43 +453,29 @@ std::optional<std::string> Mathematics::fn_exp(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_sqrt(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'v' requires one operand";
-    }
-
+std::optional<dc::Error> Mathematics::fn_sqrt(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_cmplx = is_complex(x);
+    const auto& x = stack[len];
+    auto is_x_num = x.is_number();
+    auto is_y_cmplx = x.is_complex();
 
     // Check whether the entry is a number
     if(is_x_num || is_y_cmplx) {
         stack.copy_xyz();
         auto val = stack.pop(true);
 
-        if(is_complex(val) || std::stod(val) < 0) {
-            std::complex<double> c_val;
-            std::istringstream ss1(val);
-            ss1 >> c_val;
-
-            std::complex<double> sq = std::sqrt(c_val);
-
-            // trim their digits
-            auto real_trimmed = NumericUtils::format_number(sq.real(), parameters.precision);
-            auto imag_trimmed = NumericUtils::format_number(sq.imag(), parameters.precision);
-            auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
+        if(val.is_complex() || val.to_double() < 0) {
+            std::complex<double> sq = std::sqrt(val.to_complex());
 
             // Push the result back onto the stack
-            stack.push(complex_str);
+            stack.push(dc::Value(sq, parameters.precision));
         } else {
-            stack.push(NumericUtils::format_number(sqrt(std::stod(val)), parameters.precision));
+            stack.push(dc::Value(sqrt(val.to_double()), parameters.precision));
         }
         
     } else {
-        return "'v' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "v");
     }
 
     return std::nullopt;
@@ -586,42 +491,30 @@ std::optional<std::string> Mathematics::fn_sqrt(dc::Stack<std::string> &stack, c
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_sin(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'sin' requires one operand";
-    }
-
+std::optional<dc::Error> Mathematics::fn_sin(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_x_cmplx = is_complex(x);
+    const auto& x = stack[len];
+    auto is_x_num = x.is_number();
+    auto is_x_cmplx = x.is_complex();
 
     // Check whether the entry is a number
     if(is_x_num) {
         stack.copy_xyz();
-        auto val = std::stod(stack.pop(true));
+        auto val = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(sin(val), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(sin(val), parameters.precision));
     } else if(is_x_cmplx) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         std::complex<double> s = sin(c_val);
         
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(s.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(s.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(s, parameters.precision));
     } else {
-        return "'sin' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "sin");
     }
 
     return std::nullopt;
@@ -637,42 +530,30 @@ std::optional<std::string> Mathematics::fn_sin(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_cos(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'cos' requires one operand";
-    }
-
+std::optional<dc::Error> Mathematics::fn_cos(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_x_cmplx = is_complex(x);
+    const auto& x = stack[len];
+    auto is_x_num = x.is_number();
+    auto is_x_cmplx = x.is_complex();
 
     // Check whether the entry is a number
     if(is_x_num) {
         stack.copy_xyz();
-        auto val = std::stod(stack.pop(true));
+        auto val = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(cos(val), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(cos(val), parameters.precision));
     } else if(is_x_cmplx) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         std::complex<double> s = cos(c_val);
         
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(s.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(s.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(s, parameters.precision));
     } else {
-        return "'cos' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "cos");
     }
 
     return std::nullopt;
@@ -688,42 +569,30 @@ std::optional<std::string> Mathematics::fn_cos(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_tan(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'tan' requires one operand";
-    }
-
+std::optional<dc::Error> Mathematics::fn_tan(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_x_cmplx = is_complex(x);
+    const auto& x = stack[len];
+    auto is_x_num = x.is_number();
+    auto is_x_cmplx = x.is_complex();
 
     // Check whether the entry is a number
     if(is_x_num) {
         stack.copy_xyz();
-        auto val = std::stod(stack.pop(true));
+        auto val = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(tan(val), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(tan(val), parameters.precision));
     } else if(is_x_cmplx) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         std::complex<double> s = tan(c_val);
         
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(s.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(s.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(s, parameters.precision));
     } else {
-        return "'tan' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "tan");
     }
 
     return std::nullopt;
@@ -739,42 +608,30 @@ std::optional<std::string> Mathematics::fn_tan(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_asin(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'asin' requires one operand";
-    }
-
+std::optional<dc::Error> Mathematics::fn_asin(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_x_cmplx = is_complex(x);
+    const auto& x = stack[len];
+    auto is_x_num = x.is_number();
+    auto is_x_cmplx = x.is_complex();
 
     // Check whether the entry is a number
     if(is_x_num) {
         stack.copy_xyz();
-        auto val = std::stod(stack.pop(true));
+        auto val = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(asin(val), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(asin(val), parameters.precision));
     } else if(is_x_cmplx) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         std::complex<double> s = asin(c_val);
         
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(s.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(s.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(s, parameters.precision));
     } else {
-        return "'asin' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "asin");
     }
 
     return std::nullopt;
@@ -790,42 +647,30 @@ std::optional<std::string> Mathematics::fn_asin(dc::Stack<std::string> &stack, c
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_acos(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'acos' requires one operand";
-    }
-
+std::optional<dc::Error> Mathematics::fn_acos(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_x_cmplx = is_complex(x);
+    const auto& x = stack[len];
+    auto is_x_num = x.is_number();
+    auto is_x_cmplx = x.is_complex();
 
     // Check whether the entry is a number
     if(is_x_num) {
         stack.copy_xyz();
-        auto val = std::stod(stack.pop(true));
+        auto val = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(acos(val), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(acos(val), parameters.precision));
     } else if(is_x_cmplx) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         std::complex<double> s = acos(c_val);
         
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(s.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(s.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(s, parameters.precision));
     } else {
-        return "'acos' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "acos");
     }
 
     return std::nullopt;
@@ -841,42 +686,30 @@ std::optional<std::string> Mathematics::fn_acos(dc::Stack<std::string> &stack, c
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_atan(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'atan' requires one operand";
-    }
-
+std::optional<dc::Error> Mathematics::fn_atan(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_x_cmplx = is_complex(x);
+    const auto& x = stack[len];
+    auto is_x_num = x.is_number();
+    auto is_x_cmplx = x.is_complex();
 
     // Check whether the entry is a number
     if(is_x_num) {
         stack.copy_xyz();
-        auto val = std::stod(stack.pop(true));
+        auto val = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(atan(val), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(atan(val), parameters.precision));
     } else if(is_x_cmplx) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         std::complex<double> s = atan(c_val);
         
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(s.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(s.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(s, parameters.precision));
     } else {
-        return "'atan' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "atan");
     }
 
     return std::nullopt;
@@ -892,35 +725,30 @@ std::optional<std::string> Mathematics::fn_atan(dc::Stack<std::string> &stack, c
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_fact(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'!' requires one operand";
-    }
-
+std::optional<dc::Error> Mathematics::fn_fact(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract one entry from the stack
     auto len = stack.size()-1;
-    auto x = stack[len];
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
+    const auto& x = stack[len];
+    auto is_x_num = x.is_number();
 
     // Check whether the entry is a number
     if(is_x_num) {
         stack.copy_xyz();
         unsigned long long factorial = 1;
-        auto val = std::stod(stack.pop(true));
+        auto val = stack.pop(true).to_double();
 
         if(val < 0.0) {
-            return "'!' is not defined for negative numbers";
+            return dc::Error(dc::ErrorCode::NEGATIVE_FACTORIAL);
         }
 
         for(unsigned long long i = 2; i <= val; i++) {
             factorial *= i;
         }
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(static_cast<double>(factorial), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(static_cast<double>(factorial), parameters.precision));
     } else {
-        return "'!' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "!");
     }
 
     return std::nullopt;
@@ -935,8 +763,8 @@ std::optional<std::string> Mathematics::fn_fact(dc::Stack<std::string> &stack, c
  * @param parameters An instance of the dc::Parameters data structure
  * 
  */
-std::optional<std::string> Mathematics::fn_pi(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    stack.push(NumericUtils::format_number(std::numbers::pi, parameters.precision));
+std::optional<dc::Error> Mathematics::fn_pi(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
+    stack.push(dc::Value(std::numbers::pi, parameters.precision));
 
     return std::nullopt;
 }
@@ -950,8 +778,8 @@ std::optional<std::string> Mathematics::fn_pi(dc::Stack<std::string> &stack, con
  * @param parameters An instance of the dc::Parameters data structure
  * 
  */
-std::optional<std::string> Mathematics::fn_e(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    stack.push(NumericUtils::format_number(std::numbers::e, parameters.precision));
+std::optional<dc::Error> Mathematics::fn_e(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
+    stack.push(dc::Value(std::numbers::e, parameters.precision));
 
     return std::nullopt;
 }
@@ -966,24 +794,19 @@ std::optional<std::string> Mathematics::fn_e(dc::Stack<std::string> &stack, cons
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_random(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'@' requires two operands";
-    }
-
+std::optional<dc::Error> Mathematics::fn_random(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size() - 1;
-    auto b = stack[len];
-    auto a = stack[len-1];
-    auto is_a_num = NumericUtils::is_numeric<double>(a);
-    auto is_b_num = NumericUtils::is_numeric<double>(b);
+    const auto& b = stack[len];
+    const auto& a = stack[len-1];
+    auto is_a_num = a.is_number();
+    auto is_b_num = b.is_number();
 
     // Check whether both entries are numbers
     if(is_a_num && is_b_num) {
         stack.copy_xyz();
-        auto u_bound = std::stod(stack.pop(true));
-        auto l_bound = std::stod(stack.pop(true));
+        auto u_bound = stack.pop(true).to_double();
+        auto l_bound = stack.pop(true).to_double();
         
         // Initialize random distribution with user bounds( [a, b] )
         std::random_device r_dev;
@@ -992,9 +815,9 @@ std::optional<std::string> Mathematics::fn_random(dc::Stack<std::string> &stack,
         auto r_number = u_dist(rng);
 
         // Push the random value onto the stack
-        stack.push(NumericUtils::format_number(r_number, parameters.precision));
+        stack.push(dc::Value(r_number, parameters.precision));
     } else {
-        return "'@' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "@");
     }
 
     return std::nullopt;
@@ -1008,24 +831,19 @@ std::optional<std::string> Mathematics::fn_random(dc::Stack<std::string> &stack,
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_integer(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'$' requires one operand";
-    }
-
-    auto head = stack.pop(false);
-    auto is_head_num = NumericUtils::is_numeric<double>(head);
+std::optional<dc::Error> Mathematics::fn_integer(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
+    const auto& head = stack.top();
+    auto is_head_num = head.is_number();
     
     // Check whether head of the stack is a number
     if(is_head_num) {
         stack.copy_xyz();
         // Convert to integral type to truncate
-        auto value = std::stol(stack.pop(true));
+        auto value = stack.pop(true).to_long();
         // Push the truncated number back to the stack
-        stack.push(NumericUtils::format_number(static_cast<double>(value), parameters.precision));
+        stack.push(dc::Value(static_cast<double>(value), parameters.precision));
     } else {
-        return "'$' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "$");
     }
 
     return std::nullopt;
@@ -1042,34 +860,24 @@ std::optional<std::string> Mathematics::fn_integer(dc::Stack<std::string> &stack
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_to_complex(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'b' requires two values";
-    }
-
+std::optional<dc::Error> Mathematics::fn_to_complex(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     auto len = stack.size()-1;
-    auto x = stack.at(len);
-    auto y = stack.at(len-1);
-    auto is_x_num = NumericUtils::is_numeric<double>(x);
-    auto is_y_num = NumericUtils::is_numeric<double>(y);
+    const auto& x = stack.at(len);
+    const auto& y = stack.at(len-1);
+    auto is_x_num = x.is_number();
+    auto is_y_num = y.is_number();
 
     // Check whether both values are numbers
     if(is_x_num && is_y_num) {
         // Extract the real and imaginary part of the complex number
-        auto imag = std::stod(stack.pop(true));
-        auto real = std::stod(stack.pop(true));
+        auto imag = stack.pop(true).to_double();
+        auto real = stack.pop(true).to_double();
 
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(real, parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(imag, parameters.precision);
-
-        // Complex numbers are represented on the stack as "(Re,Im)"
-        // They are then converted to std::complex before computations
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-        stack.push(complex_str);
+        // Complex numbers are printed as "(Re,Im)", with both
+        // parts trimmed according to the precision
+        stack.push(dc::Value(std::complex<double>(real, imag), parameters.precision));
     } else {
-        return "'b' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "b");
     }
 
     return std::nullopt;
@@ -1085,28 +893,21 @@ std::optional<std::string> Mathematics::fn_to_complex(dc::Stack<std::string> &st
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_get_real(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'re' requires one value";
-    }
-
-    auto head = stack.pop(false);
-    auto is_head_complex = is_complex(head);
+std::optional<dc::Error> Mathematics::fn_get_real(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
+    const auto& head = stack.top();
+    auto is_head_complex = head.is_complex();
 
     if(is_head_complex) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         // Get real part
         auto real = c_val.real();
     
         // Push the result back onto the stack
-        stack.push(NumericUtils::format_number(real, parameters.precision));
+        stack.push(dc::Value(real, parameters.precision));
     } else {
-        return "'re' requires complex values";
+        return dc::Error(dc::ErrorCode::COMPLEX_OPERANDS, "re");
     }
 
     return std::nullopt;
@@ -1122,28 +923,21 @@ std::optional<std::string> Mathematics::fn_get_real(dc::Stack<std::string> &stac
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_get_imaginary(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'im' requires one value";
-    }
-
-    auto head = stack.pop(false);
-    auto is_head_complex = is_complex(head);
+std::optional<dc::Error> Mathematics::fn_get_imaginary(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
+    const auto& head = stack.top();
+    auto is_head_complex = head.is_complex();
 
     if(is_head_complex) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         // Get imaginary part
         auto imag = c_val.imag();
     
         // Push the result back onto the stack
-        stack.push(NumericUtils::format_number(imag, parameters.precision));
+        stack.push(dc::Value(imag, parameters.precision));
     } else {
-        return "'im' requires complex values";
+        return dc::Error(dc::ErrorCode::COMPLEX_OPERANDS, "im");
     }
 
     return std::nullopt;
@@ -1160,61 +954,28 @@ std::optional<std::string> Mathematics::fn_get_imaginary(dc::Stack<std::string>
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Mathematics::fn_log10(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'y' requires one value";
-    }
-
-    auto head = stack.pop(false);
-    auto is_head_num = NumericUtils::is_numeric<double>(head);
-    auto is_head_complex = is_complex(head);
+std::optional<dc::Error> Mathematics::fn_log10(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
+    const auto& head = stack.top();
+    auto is_head_num = head.is_number();
+    auto is_head_complex = head.is_complex();
 
     if(is_head_num) {
         stack.copy_xyz();
-        auto val = std::stod(stack.pop(true));
+        auto val = stack.pop(true).to_double();
 
-        // Push back the result as a string
-        stack.push(NumericUtils::format_number(log10(val), parameters.precision));
+        // Push back the result
+        stack.push(dc::Value(log10(val), parameters.precision));
     } else if(is_head_complex) {
         stack.copy_xyz();
-        std::complex<double> c_val;
-        std::istringstream ss1(stack.pop(true));
-        ss1 >> c_val;
+        auto c_val = stack.pop(true).to_complex();
 
         std::complex<double> lg = log(c_val);
 
-        // trim their digits
-        auto real_trimmed = NumericUtils::format_number(lg.real(), parameters.precision);
-        auto imag_trimmed = NumericUtils::format_number(lg.imag(), parameters.precision);
-        auto complex_str = ('(' + real_trimmed + ',' + imag_trimmed + ')');
-
         // Push the result back onto the stack
-        stack.push(complex_str);
+        stack.push(dc::Value(lg, parameters.precision));
     } else {
-        return "'y' requires numeric values";
+        return dc::Error(dc::ErrorCode::NUMERIC_OPERANDS, "y");
     }
 
     return std::nullopt;
 }
-
-/**
- * @brief Returns true if **str** is a complex number, false otherwise
- * 
- * @param str A string containing a number
- * 
- * @return boolean value
- */
-bool Mathematics::is_complex(const std::string &str) {
-    // Complex numbers are represented on the stack as "(Re,Im)"
-    if(str.front() != '(' || str.back() != ')') {
-        return false;
-    }
-
-    // Extract "Re,Im" without parenthesis
-    std::istringstream ss(str.substr(1, str.size() - 2));
-    double real, imag;
-    char comma;
-
-    return (ss >> real >> comma >> imag) && ss.eof();
-}
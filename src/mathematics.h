@@ -18,38 +18,37 @@ public:
      * 
      * @param stack An instance of the dc::Stack data structure
      * @param parameters An instance of the dc::Parameters data structure
-     * @param regs An instance of the dc::Register data structure
+     * @param regs An instance of the dc::RegisterFile data structure
      * 
      * @return Runtime errors, if any
      */
-    std::optional<std::string> exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) override;
+    std::optional<dc::Error> exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) override;
 
 private:
-    static std::optional<std::string> fn_add(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_sub(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_mul(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_div(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_mod(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_div_mod(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_mod_exp(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_exp(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_sqrt(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_sin(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_cos(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_tan(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_asin(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_acos(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_atan(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_fact(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_pi(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_e(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_random(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_integer(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_to_complex(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_get_real(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_get_imaginary(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_log10(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static bool is_complex(const std::string &str);
+    static std::optional<dc::Error> fn_add(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_sub(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_mul(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_div(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_mod(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_div_mod(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_mod_exp(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_exp(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_sqrt(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_sin(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_cos(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_tan(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_asin(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_acos(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_atan(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_fact(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_pi(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_e(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_random(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_integer(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_to_complex(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_get_real(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_get_imaginary(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_log10(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
 
     OPType op_type;
 };
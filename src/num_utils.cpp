@@ -1,3 +1,5 @@
+#include <cstdlib>
+
 #include "num_utils.h"
 
 /**
@@ -9,15 +11,159 @@
  * @return A string containing the formatted number
  */
 std::string NumericUtils::format_number(double number, unsigned int precision) {
-    std::ostringstream oss;
+    char buf[FORMAT_BUFFER_SIZE];
+    if(auto end = format_number(number, precision, buf, buf + sizeof(buf))) {
+        return std::string(buf, end);
+    }
+
+    // Huge numbers and huge precisions do not fit into the inline buffer.
+    // A negative precision is treated as the default one, like the stream does
+    auto digits = static_cast<int>(precision);
+    std::string res(static_cast<std::size_t>(digits < 0 ? 6 : digits) + MAX_FIXED_LENGTH, '\0');
+    auto end = format_number(number, precision, res.data(), res.data() + res.size());
+    res.resize(static_cast<std::size_t>(end - res.data()));
+
+    return res;
+}
 
+/**
+ * @brief Overload of format_number that writes into a caller-provided buffer
+ *
+ * The output is the same as printing the number to a stream with
+ * std::fixed and std::setprecision, but nothing is allocated
+ *
+ * @param number The number to be formatted
+ * @param precision The precision to format the number
+ * @param first The beginning of the buffer
+ * @param last The end of the buffer
+ *
+ * @return A pointer past the last written character, nullptr if the buffer is too small
+ */
+char *NumericUtils::format_number(double number, unsigned int precision, char *first, char *last) {
     // Preserve non-zero decimals even when precision is zero
     if(precision == 0 && std::fmod(number, 1.0) != 0.0) {
         precision = 2;
     }
 
-    oss << std::fixed << std::setprecision(static_cast<int>(precision)) << number;
-    std::string res = oss.str();
+    auto [ptr, ec] = std::to_chars(first, last, number, std::chars_format::fixed, static_cast<int>(precision));
 
-    return res;
-}
\ No newline at end of file
+    return ec == std::errc() ? ptr : nullptr;
+}
+
+/**
+ * @brief Extracts a floating point number from the beginning of a string
+ *
+ * Behaves like reading a double from a std::istringstream: leading whitespaces
+ * are skipped and the longest prefix that looks like a number is consumed
+ *
+ * @param str The string to be parsed. On success, the parsed prefix is removed from it
+ *
+ * @return The parsed number, std::nullopt if the prefix is not a valid number
+ */
+std::optional<double> NumericUtils::extract_number(std::string_view &str) {
+    auto input = skip_whitespace(str);
+    auto length = scan_float(input);
+    if(length == 0) {
+        return std::nullopt;
+    }
+
+    auto number = parse_number<double>(input.substr(0, length));
+    if(number) {
+        str = input.substr(length);
+    }
+
+    return number;
+}
+
+/**
+ * @brief Removes leading whitespaces from a string
+ * @param str The string to be trimmed
+ * @return The trimmed string
+ */
+std::string_view NumericUtils::skip_whitespace(std::string_view str) {
+    auto pos = str.find_first_not_of(" \t\n\v\f\r");
+
+    return pos == std::string_view::npos ? std::string_view{} : str.substr(pos);
+}
+
+/**
+ * @brief Computes the length of the integer at the beginning of a string
+ *
+ * An integer is made of an optional sign followed by decimal digits
+ *
+ * @param str The string to be scanned
+ *
+ * @return The number of characters the stream would consume, 0 if there are no digits
+ */
+std::size_t NumericUtils::scan_integer(std::string_view str) {
+    std::size_t idx = 0;
+    if(idx < str.size() && (str[idx] == '+' || str[idx] == '-')) {
+        idx++;
+    }
+
+    auto digits_begin = idx;
+    while(idx < str.size() && str[idx] >= '0' && str[idx] <= '9') {
+        idx++;
+    }
+
+    return idx == digits_begin ? 0 : idx;
+}
+
+/**
+ * @brief Computes the length of the floating point number at the beginning of a string
+ *
+ * Mimics the scanner of the standard library: an optional sign, digits with at most
+ * one decimal point and an optional exponent, which must follow at least one digit.
+ * The scanned characters do not necessarily form a valid number(e.g., "1e+")
+ *
+ * @param str The string to be scanned
+ *
+ * @return The number of characters the stream would consume
+ */
+std::size_t NumericUtils::scan_float(std::string_view str) {
+    std::size_t idx = 0;
+    if(idx < str.size() && (str[idx] == '+' || str[idx] == '-')) {
+        idx++;
+    }
+
+    bool found_mantissa = false, found_dec = false, found_sci = false;
+    for(; idx < str.size(); idx++) {
+        auto c = str[idx];
+        if(c >= '0' && c <= '9') {
+            found_mantissa = true;
+        } else if(c == '.' && !found_dec && !found_sci) {
+            found_dec = true;
+        } else if((c == 'e' || c == 'E') && !found_sci && found_mantissa) {
+            found_sci = true;
+            // The exponent sign is consumed along with the exponent marker
+            if(idx + 1 < str.size() && (str[idx + 1] == '+' || str[idx + 1] == '-')) {
+                idx++;
+            }
+        } else {
+            break;
+        }
+    }
+
+    return idx;
+}
+
+/**
+ * @brief Parses a number that does not fit into a double
+ *
+ * Numbers that are too small are rounded to zero(or to a subnormal number), while
+ * numbers that are too big are rejected, as the stream does
+ *
+ * @param str A string containing a well-formed number
+ *
+ * @return The parsed number, std::nullopt if the number overflows
+ */
+std::optional<double> NumericUtils::parse_out_of_range(std::string_view str) {
+    // std::strtod requires a null-terminated string
+    std::string buf(str);
+    auto number = std::strtod(buf.c_str(), nullptr);
+    if(std::isinf(number)) {
+        return std::nullopt;
+    }
+
+    return number;
+}
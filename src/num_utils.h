@@ -1,8 +1,11 @@
 #pragma once
 
-#include <sstream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <charconv>
 #include <cmath>
-#include <iomanip>
+#include <type_traits>
 
 /**
  * @brief Constrains a generic type to integral/float type
@@ -18,12 +21,78 @@ concept numeric = std::is_arithmetic_v<T>;
 class NumericUtils {
 public:
     NumericUtils() = delete;
+    static constexpr std::size_t FORMAT_BUFFER_SIZE = 64;
     static std::string format_number(double number, unsigned int precision);
+    static char *format_number(double number, unsigned int precision, char *first, char *last);
     template <typename T>
     requires numeric<T>
-    static bool is_numeric(const std::string &str);
+    static std::optional<T> parse_number(std::string_view str);
+    template <typename T>
+    requires numeric<T>
+    static bool is_numeric(std::string_view str);
+    static std::optional<double> extract_number(std::string_view &str);
+
+private:
+    // Sign, integer digits of the largest double and decimal point
+    static constexpr std::size_t MAX_FIXED_LENGTH = 311;
+
+    static std::string_view skip_whitespace(std::string_view str);
+    static std::size_t scan_integer(std::string_view str);
+    static std::size_t scan_float(std::string_view str);
+    static std::optional<double> parse_out_of_range(std::string_view str);
 };
 
+/**
+ * @brief Classifies and parses a number in a single pass
+ *
+ * Accepts exactly the strings that would be entirely consumed by
+ * reading a value of type T from a std::istringstream(i.e., leading
+ * whitespaces, an optional sign and, for floating point types, decimal
+ * digits and exponent), without building a stream or allocating memory
+ *
+ * @param str A string containing either a numeric or a non-numeric value
+ *
+ * @return The parsed number if the string is a number of type T, std::nullopt otherwise
+ */
+template <typename T>
+requires numeric<T>
+std::optional<T> NumericUtils::parse_number(std::string_view str) {
+    str = skip_whitespace(str);
+    auto length = std::is_floating_point_v<T> ? scan_float(str) : scan_integer(str);
+    if(length == 0 || length != str.size()) {
+        return std::nullopt;
+    }
+
+    // std::from_chars does not accept the plus sign
+    if(str.front() == '+') {
+        str.remove_prefix(1);
+    }
+
+    // Unsigned types wrap negative numbers around, like the stream does
+    bool negative = false;
+    if constexpr(std::is_unsigned_v<T>) {
+        if(!str.empty() && str.front() == '-') {
+            negative = true;
+            str.remove_prefix(1);
+        }
+    }
+
+    T number{};
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), number);
+    if constexpr(std::is_floating_point_v<T>) {
+        if(ec == std::errc::result_out_of_range) {
+            auto result = parse_out_of_range(str);
+            return result ? std::optional<T>(static_cast<T>(*result)) : std::nullopt;
+        }
+    }
+
+    if(ec != std::errc() || ptr != str.data() + str.size()) {
+        return std::nullopt;
+    }
+
+    return negative ? static_cast<T>(-number) : number;
+}
+
 /**
  * @brief Determines whether a given string is a number or not
  * 
@@ -36,9 +105,6 @@ public:
  */
 template <typename T>
 requires numeric<T>
-bool NumericUtils::is_numeric(const std::string &str) {
-    std::istringstream ss(str);
-    T number;
-
-    return (ss >> number) && ss.eof();
-}
\ No newline at end of file
+bool NumericUtils::is_numeric(std::string_view str) {
+    return parse_number<T>(str).has_value();
+}
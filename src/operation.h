@@ -2,6 +2,8 @@
 #include <optional>
 
 #include "adt.h"
+#include "register_file.h"
+#include "error.h"
 /**
  * @brief This protocol establishes a set of methods to which every DC operation(represented by a class) must adhere.
  * 
@@ -13,11 +15,11 @@ public:
      * 
      * @param stack An instance of the dc::Stack data structure
      * @param parameters An instance of the dc::Parameters data structure
-     * @param regs An instance of the dc::Register data structure
+     * @param regs An instance of the dc::RegisterFile data structure
      * 
      * @return Runtime errors, if any
      */
-    virtual std::optional<std::string> exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) = 0;
+    virtual std::optional<dc::Error> exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) = 0;
     virtual ~IOperation() = default;
 };
 
@@ -32,7 +34,7 @@ enum class OPType {
     BAND, BOR, BNOT, BXOR, BSL, BSR,
     // Stack operations
     PCG, PWS, P, PBB, PBH, PBO, CLR, PH, SO, DP, PS, CH, CS, 
-    SP, GP, SOR, GOR, SIR, GIR, LX, LY, LZ,
+    SP, GP, SOR, GOR, SIR, GIR, LX, LY, LZ, FL,
     // Macro operations
     EX, CMP, RI, LF
 };
@@ -0,0 +1,147 @@
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+#include "output.h"
+
+namespace dc {
+    // The output bound to the current thread, if any
+    static thread_local Output *bound_output = nullptr;
+
+    /**
+     * @brief Retrieves the output of the current thread
+     *
+     * Unless the thread has bound its own output, this is the output of the process, whose buffer is
+     * flushed and whose sink is closed when the instance is destroyed, that is, when the program exits
+     *
+     * @return The output bound to the thread or the singleton instance of the output
+     */
+    Output &Output::instance() {
+        if(bound_output != nullptr) {
+            return *bound_output;
+        }
+
+        static Output output;
+
+        return output;
+    }
+
+    /**
+     * @brief Binds an output to the current thread
+     * @param output The output returned by Output::instance on this thread, nullptr to restore the output of the process
+     */
+    void Output::bind(Output *output) {
+        bound_output = output;
+    }
+
+    Output::Output()
+        : buffer(std::make_unique_for_overwrite<char[]>(BUFFER_SIZE)), line_buffered(isatty(STDOUT_FILENO) == 1) {}
+
+    /**
+     * @brief Creates a fully buffered output whose blocks are handed to a sink
+     * @param s The sink taking the flushed blocks
+     */
+    Output::Output(OutputSink *s)
+        : buffer(std::make_unique_for_overwrite<char[]>(BUFFER_SIZE)), line_buffered(false), sink(s) {}
+
+    Output::~Output() {
+        flush();
+        if(this->sink != nullptr) {
+            this->sink->close();
+        }
+    }
+
+    /**
+     * @brief Appends a string to the buffer
+     * @param str The string to be written
+     */
+    void Output::write(std::string_view str) {
+        if(this->length + str.size() > BUFFER_SIZE) {
+            flush();
+            // Strings larger than the buffer are not copied
+            if(str.size() > BUFFER_SIZE) {
+                if(this->sink != nullptr) {
+                    this->sink->write(STDOUT_FILENO, std::string(str));
+                } else {
+                    write_all(STDOUT_FILENO, str.data(), str.size());
+                }
+                return;
+            }
+        }
+
+        std::memcpy(this->buffer.get() + this->length, str.data(), str.size());
+        this->length += str.size();
+
+        if(this->line_buffered && str.find('\n') != std::string_view::npos) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Appends a character to the buffer
+     * @param c The character to be written
+     */
+    void Output::put(char c) {
+        write(std::string_view(&c, 1));
+    }
+
+    /**
+     * @brief Writes the content of the buffer to the standard output, or hands it to the sink
+     */
+    void Output::flush() {
+        if(this->length == 0) {
+            return;
+        }
+
+        if(this->sink != nullptr) {
+            this->sink->write(STDOUT_FILENO, std::string(this->buffer.get(), this->length));
+        } else {
+            write_all(STDOUT_FILENO, this->buffer.get(), this->length);
+        }
+        this->length = 0;
+    }
+
+    /**
+     * @brief Writes an error message, followed by a newline, to the standard error
+     *
+     * The buffered output is flushed first
+     *
+     * @param message The message to be written
+     */
+    void Output::error(std::string_view message) {
+        flush();
+
+        std::string line(message);
+        line.push_back('\n');
+        if(this->sink != nullptr) {
+            this->sink->write(STDERR_FILENO, std::move(line));
+        } else {
+            write_all(STDERR_FILENO, line.data(), line.size());
+        }
+    }
+
+    /**
+     * @brief Writes a block of data to a file descriptor
+     *
+     * Interrupted and partial writes are resumed, while the data is dropped
+     * if the file cannot be written(e.g., a closed pipe)
+     *
+     * @param fd The file descriptor
+     * @param data The data to be written
+     * @param size The size of the data
+     */
+    void Output::write_all(int fd, const char *data, std::size_t size) {
+        while(size != 0) {
+            auto count = ::write(fd, data, size);
+            if(count == -1) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+
+            data += count;
+            size -= static_cast<std::size_t>(count);
+        }
+    }
+}
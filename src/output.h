@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstddef>
+
+namespace dc {
+    /**
+     * @brief Destination of the flushed output, see Output::set_sink
+     */
+    class OutputSink {
+    public:
+        /**
+         * @brief Takes a block of output
+         * @param fd The file descriptor the block must be written to
+         * @param data The content of the block
+         */
+        virtual void write(int fd, std::string data) = 0;
+
+        /**
+         * @brief Writes the pending blocks and stops taking new ones
+         */
+        virtual void close() = 0;
+        virtual ~OutputSink() = default;
+    };
+
+    /**
+     * @brief Buffered standard output
+     *
+     * Printing commands append their text to a large user-space buffer, which is written to the
+     * standard output when it is full, when the program exits, before reading from the standard input
+     * and when the flush command(i.e., 'w') is executed. When the standard output is a terminal, the
+     * buffer is also flushed at the end of each line. Errors are written to the standard error through
+     * Output::error, which flushes the buffer first, so that the two streams keep their order.
+     * Flushed blocks can be handed to a sink(e.g., a writer thread) instead of being written. A thread can
+     * bind its own output(see Output::bind), which Output::instance then returns in place of the output of the process
+     */
+    class Output {
+    public:
+        static Output &instance();
+        static void bind(Output *output);
+        explicit Output(OutputSink *s);
+        Output(const Output&) = delete;
+        Output &operator=(const Output&) = delete;
+        ~Output();
+        void write(std::string_view str);
+        void put(char c);
+        void flush();
+        void error(std::string_view message);
+        void set_sink(OutputSink *s) { this->sink = s; }
+        void set_line_buffered(bool on) { this->line_buffered = on; }
+        [[nodiscard]] bool is_line_buffered() const { return this->line_buffered; }
+        static void write_all(int fd, const char *data, std::size_t size);
+
+        static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+    private:
+        Output();
+
+        std::unique_ptr<char[]> buffer;
+        std::size_t length = 0;
+        bool line_buffered;
+        OutputSink *sink = nullptr;
+    };
+}
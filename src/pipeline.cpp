@@ -0,0 +1,187 @@
+#include <memory>
+#include <array>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+#include "eval.h"
+#include "macro.h"
+#include "pipeline.h"
+
+/**
+ * @brief Evaluates the standard input until it is over
+ *
+ * The output of the process is redirected to the writer thread for the whole evaluation. When a line quits,
+ * the reader thread is stopped and the lines it has already read are discarded
+ */
+void Pipeline::run() {
+    if(pipe(this->stop_fds.data()) == -1) {
+        this->stop_fds = {-1, -1};
+    }
+
+    this->writer = std::thread(&Pipeline::write_output, this);
+    this->reader = std::thread(&Pipeline::read_input, this);
+
+    auto &output = dc::Output::instance();
+    output.set_sink(this);
+    Macro::set_input([this](std::string &user_input) {
+        std::string_view next;
+        if(!next_line(next)) {
+            return false;
+        }
+        user_input.assign(next);
+
+        return true;
+    });
+
+    std::string_view line;
+    while(next_line(line)) {
+        // Evaluate expression. Programs do not reference their source code,
+        // therefore the line can be released by '?'
+        this->arena.reset();
+        Evaluate evaluator(line, this->regs, this->stack, this->parameters, &this->arena);
+        auto err = evaluator.eval();
+        if(err != std::nullopt && err->is_quit()) {
+            break;
+        }
+
+        // Handle errors
+        if(err != std::nullopt) {
+            output.error(err->message());
+        }
+    }
+
+    // Stop the reader, which might be waiting for the standard input
+    if(!this->batch.last && this->stop_fds[1] != -1) {
+        while(::write(this->stop_fds[1], "", 1) == -1 && errno == EINTR) {}
+    }
+    while(!this->batch.last) {
+        this->batch = this->batches.pop();
+    }
+    this->reader.join();
+    ::close(this->stop_fds[0]);
+    ::close(this->stop_fds[1]);
+
+    output.flush();
+    output.set_sink(nullptr);
+    Macro::set_input(nullptr);
+    close();
+}
+
+/**
+ * @brief Hands a block of output to the writer thread
+ * @param fd The file descriptor the block must be written to
+ * @param data The content of the block
+ */
+void Pipeline::write(int fd, std::string data) {
+    this->blocks.push(Block{fd, std::move(data)});
+}
+
+/**
+ * @brief Waits for the writer thread to write the pending blocks
+ *
+ * Called when the evaluation is over or when the program quits
+ */
+void Pipeline::close() {
+    if(this->closed) {
+        return;
+    }
+
+    this->closed = true;
+    this->blocks.push(Block{});
+    this->writer.join();
+}
+
+/**
+ * @brief Body of the reader thread
+ *
+ * Reads the standard input in blocks of Pipeline::READ_SIZE bytes and splits them into lines. A line spanning
+ * two blocks is carried over to the next batch. The last line does not need to end with a newline.
+ * The reader also stops when the stop pipe becomes readable
+ */
+void Pipeline::read_input() {
+    std::string carry;
+
+    while(true) {
+        Batch next;
+        next.text = std::move(carry);
+        auto offset = next.text.size();
+
+        std::array<pollfd, 2> fds{{{STDIN_FILENO, POLLIN, 0}, {this->stop_fds[0], POLLIN, 0}}};
+        auto ready = poll(fds.data(), fds.size(), -1);
+        if(ready == -1 && errno == EINTR) {
+            carry = std::move(next.text);
+            continue;
+        }
+
+        ssize_t count = 0;
+        if(ready != -1 && fds[1].revents == 0) {
+            next.text.resize(offset + READ_SIZE);
+            count = ::read(STDIN_FILENO, next.text.data() + offset, READ_SIZE);
+            if(count == -1 && errno == EINTR) {
+                carry.assign(next.text, 0, offset);
+                continue;
+            }
+        }
+
+        if(count <= 0) {
+            next.text.resize(offset);
+            if(!next.text.empty()) {
+                next.ends.push_back(next.text.size());
+            }
+            next.last = true;
+            this->batches.push(std::move(next));
+            return;
+        }
+
+        next.text.resize(offset + static_cast<std::size_t>(count));
+        for(auto pos = next.text.find('\n', offset); pos != std::string::npos; pos = next.text.find('\n', pos + 1)) {
+            next.ends.push_back(pos);
+        }
+
+        if(next.ends.empty()) {
+            carry = std::move(next.text);
+            continue;
+        }
+
+        carry.assign(next.text, next.ends.back() + 1);
+        next.text.resize(next.ends.back() + 1);
+        this->batches.push(std::move(next));
+    }
+}
+
+/**
+ * @brief Body of the writer thread
+ */
+void Pipeline::write_output() {
+    while(true) {
+        auto block = this->blocks.pop();
+        if(block.fd == -1) {
+            return;
+        }
+
+        dc::Output::write_all(block.fd, block.data.data(), block.data.size());
+    }
+}
+
+/**
+ * @brief Takes the next line read by the reader thread
+ * @param line The line
+ * @return false when the standard input is over, true otherwise
+ */
+bool Pipeline::next_line(std::string_view &line) {
+    while(this->line_idx == this->batch.ends.size()) {
+        if(this->batch.last) {
+            return false;
+        }
+
+        this->batch = this->batches.pop();
+        this->line_idx = 0;
+    }
+
+    auto begin = (this->line_idx == 0) ? 0 : this->batch.ends[this->line_idx - 1] + 1;
+    line = std::string_view(this->batch.text).substr(begin, this->batch.ends[this->line_idx] - begin);
+    this->line_idx++;
+
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <thread>
+#include <cstddef>
+
+#include "adt.h"
+#include "register_file.h"
+#include "arena.h"
+#include "output.h"
+#include "spsc_queue.h"
+
+/**
+ * @brief Evaluates the standard input on three threads
+ *
+ * A reader thread reads the standard input in large blocks and splits them into lines, the calling thread
+ * evaluates the lines and a writer thread writes the output. The threads are connected by lock-free queues
+ * (see dc::SpscQueue), so that the evaluation does not wait for I/O. Lines are evaluated in order, one at a time,
+ * and both the output and the errors go through the writer, thus the result is the same as evaluating
+ * the lines sequentially. Lines read by '?' are taken from the reader as well. When a line quits('q'), the lines
+ * that follow it are not evaluated
+ */
+class Pipeline : public dc::OutputSink {
+public:
+    /**
+     * @brief Constructor of Pipeline
+     * @param r An instance of the dc::RegisterFile data structure
+     * @param s An instance of the dc::Stack data structure
+     * @param p An instance of the dc::Parameters data structure
+     * @param a The arena the program of each line is allocated by
+     */
+    Pipeline(dc::RegisterFile &r, dc::Stack<dc::Value> &s, dc::Parameters &p, dc::Arena &a)
+        : regs(r), stack(s), parameters(p), arena(a) {}
+    Pipeline(const Pipeline&) = delete;
+    Pipeline &operator=(const Pipeline&) = delete;
+    void run();
+    void write(int fd, std::string data) override;
+    void close() override;
+
+    // Size of the reads from the standard input
+    static constexpr std::size_t READ_SIZE = 256 * 1024;
+
+private:
+    /**
+     * @brief A block of whole lines read from the standard input
+     */
+    struct Batch {
+        std::string text;
+        std::vector<std::size_t> ends;  // Offset of the end of each line
+        bool last = false;              // Whether the standard input is over
+    };
+
+    /**
+     * @brief A block of output to be written
+     */
+    struct Block {
+        int fd = -1;                    // The writer stops at a block without a file descriptor
+        std::string data;
+    };
+
+    void read_input();
+    void write_output();
+    bool next_line(std::string_view &line);
+
+    dc::RegisterFile &regs;
+    dc::Stack<dc::Value> &stack;
+    dc::Parameters &parameters;
+    dc::Arena &arena;
+    dc::SpscQueue<Batch, 16> batches;
+    dc::SpscQueue<Block, 64> blocks;
+    Batch batch;
+    std::size_t line_idx = 0;
+    bool closed = false;
+    std::array<int, 2> stop_fds{-1, -1};    // Pipe that stops the reader thread
+    std::thread reader;
+    std::thread writer;
+};
@@ -0,0 +1,70 @@
+#include <algorithm>
+
+#include "register_array.h"
+
+namespace dc {
+    /**
+     * @brief Stores a value into the array, overwriting the previous one
+     * @param idx The index of the value
+     * @param value The value to be stored
+     */
+    void RegisterArray::store(int idx, Value value) {
+        if(idx >= 0) {
+            auto pos = static_cast<std::size_t>(idx);
+            // Grow the vector as long as it stays at least half full
+            if(pos >= this->dense.size() && pos < std::max(MIN_DENSE, 2 * (this->dense_count + 1))) {
+                grow(pos + 1);
+            }
+
+            if(pos < this->dense.size()) {
+                auto &slot = this->dense[pos];
+                if(!slot.has_value()) {
+                    this->dense_count++;
+                    this->count++;
+                }
+                slot = std::move(value);
+
+                return;
+            }
+        }
+
+        if(this->sparse.insert_or_assign(idx, std::move(value)).second) {
+            this->count++;
+        }
+    }
+
+    /**
+     * @brief Retrieves a value from the array
+     * @param idx The index of the value
+     * @return The value, nullptr if there is no value at the index
+     */
+    const Value *RegisterArray::find(int idx) const {
+        if(idx >= 0 && static_cast<std::size_t>(idx) < this->dense.size()) {
+            const auto &slot = this->dense[static_cast<std::size_t>(idx)];
+
+            return slot.has_value() ? &slot.value() : nullptr;
+        }
+
+        auto it = this->sparse.find(idx);
+
+        return (it != this->sparse.end()) ? &it->second : nullptr;
+    }
+
+    /**
+     * @brief Extends the vector, moving the values it now covers out of the hash map
+     * @param length The new length of the vector
+     */
+    void RegisterArray::grow(std::size_t length) {
+        this->dense.resize(length);
+
+        for(auto it = this->sparse.begin(); it != this->sparse.end();) {
+            if(it->first >= 0 && static_cast<std::size_t>(it->first) < this->dense.size()) {
+                this->dense[static_cast<std::size_t>(it->first)] = std::move(it->second);
+                this->dense_count++;
+                it = this->sparse.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <cstddef>
+
+#include "value.h"
+
+namespace dc {
+    /**
+     * @brief The array of a register
+     *
+     * Arrays are mostly used as tables indexed from zero(e.g., lookup tables), thus
+     * non-negative indices are stored into a contiguous vector, as long as the vector is
+     * at least half full. Negative indices and indices far beyond the end of the vector
+     * are stored into a hash map instead, so that sparse arrays do not waste memory.
+     */
+    class RegisterArray {
+    public:
+        void store(int idx, Value value);
+        [[nodiscard]] const Value *find(int idx) const;
+        [[nodiscard]] bool empty() const { return this->count == 0; }
+
+        // Indices below this limit are always stored into the vector
+        static constexpr std::size_t MIN_DENSE = 64;
+
+    private:
+        void grow(std::size_t length);
+
+        std::vector<std::optional<Value>> dense;
+        std::unordered_map<int, Value> sparse;
+        std::size_t dense_count = 0;
+        std::size_t count = 0;
+    };
+}
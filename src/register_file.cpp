@@ -0,0 +1,29 @@
+#include "register_file.h"
+
+namespace dc {
+    /**
+     * @brief Copies the defined registers of another register file
+     * @param other The register file to be copied
+     */
+    RegisterFile::RegisterFile(const RegisterFile &other) {
+        for(std::size_t idx = 0; idx < SIZE; idx++) {
+            if(other.slots[idx] != nullptr) {
+                this->slots[idx] = std::make_unique<Register>(*other.slots[idx]);
+            }
+        }
+    }
+
+    /**
+     * @brief Gets a register, allocating it if it is undefined
+     * @param name The name of the register
+     * @return The register
+     */
+    Register &RegisterFile::operator[](char name) {
+        auto &slot = this->slots[index(name)];
+        if(slot == nullptr) {
+            slot = std::make_unique<Register>();
+        }
+
+        return *slot;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <cstddef>
+
+#include "adt.h"
+
+namespace dc {
+    /**
+     * @brief The registers of the DC virtual machine
+     *
+     * Each register has its own slot, indexed by the name of the register, thus accessing
+     * a register is an array index rather than a hash lookup. Registers are allocated lazily,
+     * the first time they are written, so that undefined registers can still be told apart
+     * from empty ones. Copies share the strings(e.g., the bodies of macros) of the original registers.
+     */
+    class RegisterFile {
+    public:
+        RegisterFile() = default;
+        RegisterFile(const RegisterFile &other);
+        RegisterFile &operator=(const RegisterFile&) = delete;
+
+        static constexpr std::size_t SIZE = 256;
+
+        [[nodiscard]] Register *find(char name) { return this->slots[index(name)].get(); }
+        Register &operator[](char name);
+        void erase(char name) { this->slots[index(name)].reset(); }
+
+    private:
+        static std::size_t index(char name) { return static_cast<unsigned char>(name); }
+
+        std::array<std::unique_ptr<Register>, SIZE> slots;
+    };
+}
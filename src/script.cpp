@@ -0,0 +1,109 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "eval.h"
+#include "lexer.h"
+#include "script.h"
+
+/**
+ * @brief Opens a source file
+ *
+ * Regular files are mapped into memory, while other files are read into a buffer.
+ * Whether the file has been opened can be checked with Script::is_open
+ *
+ * @param file_name The name of the file
+ */
+Script::Script(const std::string &file_name) {
+    auto fd = ::open(file_name.c_str(), O_RDONLY);
+    if(fd == -1) {
+        return;
+    }
+
+    struct stat info{};
+    if(fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        auto length = static_cast<std::size_t>(info.st_size);
+        auto *ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(ptr != MAP_FAILED) {
+            // The file is lexed from the beginning to the end
+            madvise(ptr, length, MADV_SEQUENTIAL);
+            this->mapping = ptr;
+            this->size = length;
+            this->source = std::string_view(static_cast<const char*>(ptr), length);
+        }
+    }
+
+    if(this->mapping == nullptr) {
+        char chunk[64 * 1024];
+        ssize_t count;
+        while((count = ::read(fd, chunk, sizeof(chunk))) > 0) {
+            this->buffer.append(chunk, static_cast<std::size_t>(count));
+        }
+
+        if(count == -1) {
+            close(fd);
+            return;
+        }
+
+        this->source = this->buffer;
+    }
+
+    close(fd);
+    this->open = true;
+}
+
+Script::~Script() {
+    if(this->mapping != nullptr) {
+        munmap(this->mapping, this->size);
+    }
+}
+
+/**
+ * @brief Evaluates the file, one statement at a time
+ *
+ * @param regs An instance of the dc::RegisterFile data structure
+ * @param stack An instance of the dc::Stack data structure
+ * @param parameters An instance of the dc::Parameters data structure
+ * @param arena The arena the program of each statement is allocated by, it is reset for each statement
+ *
+ * @return The error of the first statement that fails, if any
+ */
+std::optional<dc::Error> Script::eval(dc::RegisterFile &regs, dc::Stack<dc::Value> &stack, dc::Parameters &parameters,
+                                      dc::Arena &arena) {
+    Lexer lexer(this->source);
+    while(auto statement = lexer.next_statement()) {
+        // Evaluate statement
+        arena.reset();
+        Evaluate evaluator(*statement, regs, stack, parameters, &arena);
+        auto err = evaluator.eval();
+        // Handle errors
+        if(err != std::nullopt) {
+            return err;
+        }
+
+        // Programs do not reference their source code, thus the statement can be released
+        release(static_cast<std::size_t>(statement->data() + statement->size() - this->source.data()));
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Hands the pages before **offset** back to the kernel
+ *
+ * Pages are released once at least Script::RELEASE_SIZE bytes have been evaluated. The pages are only
+ * dropped from the mapping, thus reading them again would fetch them from the file
+ *
+ * @param offset The offset of the end of the last evaluated statement
+ */
+void Script::release(std::size_t offset) {
+    if(this->mapping == nullptr || offset - this->released < RELEASE_SIZE) {
+        return;
+    }
+
+    static const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto end = offset / page_size * page_size;
+    madvise(static_cast<char*>(this->mapping) + this->released, end - this->released, MADV_DONTNEED);
+    this->released = end;
+}
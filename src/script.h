@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstddef>
+
+#include "adt.h"
+#include "error.h"
+#include "register_file.h"
+#include "arena.h"
+
+/**
+ * @brief A DC source file mapped into memory
+ *
+ * The file is mapped rather than read, so that statements are lexed directly from the mapping without
+ * copying them. Statements are evaluated one at a time(see Lexer::next_statement), each in a fresh
+ * program allocated by an arena, and the pages of the statements already evaluated are handed back to the kernel,
+ * therefore the memory in use does not grow with the size of the file. Files that cannot be mapped(e.g., pipes)
+ * are read into memory instead
+ */
+class Script {
+public:
+    explicit Script(const std::string &file_name);
+    Script(const Script&) = delete;
+    Script &operator=(const Script&) = delete;
+    ~Script();
+
+    /**
+     * @brief Returns true if the file has been opened, false otherwise
+     * @return Boolean value
+     */
+    [[nodiscard]] bool is_open() const { return this->open; }
+    std::optional<dc::Error> eval(dc::RegisterFile &regs, dc::Stack<dc::Value> &stack, dc::Parameters &parameters,
+                                  dc::Arena &arena);
+
+    // Evaluated statements are released in chunks of this size
+    static constexpr std::size_t RELEASE_SIZE = 16 * 1024 * 1024;
+
+private:
+    void release(std::size_t offset);
+
+    void *mapping = nullptr;
+    std::size_t size = 0;
+    std::size_t released = 0;
+    std::string buffer;
+    std::string_view source;
+    bool open = false;
+};
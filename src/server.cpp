@@ -0,0 +1,314 @@
+#include <array>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+
+#include "eval.h"
+#include "macro.h"
+#include "server.h"
+
+/**
+ * @brief Fills the address of a Unix domain socket
+ * @param path The path of the socket
+ * @param addr The address
+ * @return false if the path is too long, true otherwise
+ */
+static bool socket_address(const std::string &path, sockaddr_un &addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.data(), path.size());
+
+    return true;
+}
+
+/**
+ * @brief Constructor of Server, which starts listening on the socket
+ *
+ * A socket left behind by a server that is no longer running is replaced,
+ * while the socket of a running server is not
+ *
+ * @param socket_path The path of the socket
+ * @param lib The session every connection starts with
+ * @param a The arena the program of each line is allocated by
+ */
+Server::Server(const std::string &socket_path, const Session &lib, dc::Arena &a)
+    : path(socket_path), library(lib), arena(a), output(this) {
+    sockaddr_un addr{};
+    if(!socket_address(this->path, addr)) {
+        return;
+    }
+
+    struct stat info{};
+    if(stat(this->path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool running = probe != -1 && connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        if(probe != -1) {
+            ::close(probe);
+        }
+        if(running) {
+            return;
+        }
+        unlink(this->path.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd == -1) {
+        return;
+    }
+
+    if(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 || listen(fd, SOMAXCONN) == -1) {
+        ::close(fd);
+        return;
+    }
+
+    this->listen_fd = fd;
+}
+
+/**
+ * @brief Closes the connections and removes the socket
+ */
+Server::~Server() {
+    for(const auto &[fd, conn] : this->connections) {
+        ::close(fd);
+    }
+
+    if(this->listen_fd != -1) {
+        ::close(this->listen_fd);
+        unlink(this->path.c_str());
+    }
+}
+
+/**
+ * @brief Serves the connections until SIGINT or SIGTERM is received
+ *
+ * The output of the process is redirected to the reply of the line being evaluated
+ */
+void Server::run() {
+    // The signals are taken from a file descriptor, so that they are handled by the event loop
+    sigset_t signals;
+    sigset_t previous;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, &previous);
+    this->signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    this->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = this->listen_fd;
+    epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->listen_fd, &event);
+    event.data.fd = this->signal_fd;
+    epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->signal_fd, &event);
+
+    dc::Output::bind(&this->output);
+    Macro::set_input([](std::string&) { return false; });
+
+    std::array<epoll_event, MAX_EVENTS> events{};
+    bool running = this->signal_fd != -1 && this->epoll_fd != -1;
+    while(running) {
+        auto count = epoll_wait(this->epoll_fd, events.data(), MAX_EVENTS, -1);
+        if(count == -1) {
+            running = (errno == EINTR);
+            continue;
+        }
+
+        for(int idx = 0; idx < count; idx++) {
+            auto fd = events[idx].data.fd;
+            if(fd == this->signal_fd) {
+                // Consume the signal, otherwise it would be delivered once unblocked
+                signalfd_siginfo info{};
+                while(::read(this->signal_fd, &info, sizeof(info)) == -1 && errno == EINTR) {}
+                running = false;
+            } else if(fd == this->listen_fd) {
+                accept_connections();
+            } else if(auto it = this->connections.find(fd); it != this->connections.end()) {
+                auto &conn = *it->second;
+                if(events[idx].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    receive(fd, conn);
+                }
+                if(this->connections.contains(fd)) {
+                    send_replies(fd, conn);
+                }
+            }
+        }
+    }
+
+    Macro::set_input(nullptr);
+    dc::Output::bind(nullptr);
+    ::close(this->epoll_fd);
+    ::close(this->signal_fd);
+    sigprocmask(SIG_SETMASK, &previous, nullptr);
+}
+
+/**
+ * @brief Accepts the pending connections, each one with a new session
+ */
+void Server::accept_connections() {
+    while(true) {
+        int fd = accept4(this->listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd == -1) {
+            if(errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if(epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            ::close(fd);
+            continue;
+        }
+
+        this->connections.emplace(fd, std::make_unique<Connection>(this->library));
+    }
+}
+
+/**
+ * @brief Reads from a connection and evaluates the complete lines
+ *
+ * When the client closes its side, the last line is evaluated even if it does not end with a newline,
+ * while a client that sends a line longer than Server::MAX_LINE_SIZE is disconnected, so that
+ * the buffer of a connection cannot grow without limit
+ *
+ * @param fd The socket of the connection
+ * @param conn The connection
+ */
+void Server::receive(int fd, Connection &conn) {
+    auto offset = conn.input.size();
+    conn.input.resize(offset + READ_SIZE);
+    auto count = ::read(fd, conn.input.data() + offset, READ_SIZE);
+    if(count == -1 && (errno == EAGAIN || errno == EINTR)) {
+        conn.input.resize(offset);
+        return;
+    }
+
+    if(count <= 0) {
+        conn.input.resize(offset);
+        if(count == -1) {
+            drop(fd);
+            return;
+        }
+        if(!conn.input.empty() && !conn.closing) {
+            evaluate(conn, conn.input);
+        }
+        conn.input.clear();
+        conn.closing = true;
+        return;
+    }
+
+    conn.input.resize(offset + static_cast<std::size_t>(count));
+    std::size_t begin = 0;
+    for(auto pos = conn.input.find('\n', offset); pos != std::string::npos && !conn.closing;
+        pos = conn.input.find('\n', begin)) {
+        evaluate(conn, std::string_view(conn.input).substr(begin, pos - begin));
+        begin = pos + 1;
+    }
+    conn.input.erase(0, begin);
+
+    if(conn.input.size() > MAX_LINE_SIZE) {
+        drop(fd);
+    }
+}
+
+/**
+ * @brief Evaluates a line in the session of a connection and queues its reply
+ * @param conn The connection
+ * @param line The line to be evaluated
+ */
+void Server::evaluate(Connection &conn, std::string_view line) {
+    this->out.clear();
+    this->err.clear();
+
+    this->arena.reset();
+    {
+        Evaluate evaluator(line, conn.session.regs, conn.session.stack, conn.session.parameters, &this->arena);
+        auto error = evaluator.eval();
+        if(error != std::nullopt && error->is_quit()) {
+            conn.closing = true;
+        } else if(error != std::nullopt) {
+            this->output.error(error->message());
+        }
+    }
+    this->output.flush();
+
+    conn.replies += std::to_string(this->out.size()) + ' ' + std::to_string(this->err.size()) + '\n';
+    conn.replies += this->out;
+    conn.replies += this->err;
+}
+
+/**
+ * @brief Sends the queued replies of a connection
+ *
+ * While some replies cannot be sent, the connection waits to be writable
+ * and no more lines are read from it
+ *
+ * @param fd The socket of the connection
+ * @param conn The connection
+ */
+void Server::send_replies(int fd, Connection &conn) {
+    while(conn.sent < conn.replies.size()) {
+        auto count = send(fd, conn.replies.data() + conn.sent, conn.replies.size() - conn.sent,
+                          MSG_NOSIGNAL | MSG_DONTWAIT);
+        if(count == -1) {
+            if(errno == EINTR) {
+                continue;
+            }
+            if(errno == EAGAIN) {
+                break;
+            }
+            drop(fd);
+            return;
+        }
+        conn.sent += static_cast<std::size_t>(count);
+    }
+
+    auto pending = conn.sent < conn.replies.size();
+    if(!pending) {
+        conn.replies.clear();
+        conn.sent = 0;
+        if(conn.closing) {
+            drop(fd);
+            return;
+        }
+    }
+
+    if(pending != conn.writing) {
+        epoll_event event{};
+        event.events = pending ? EPOLLOUT : EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(this->epoll_fd, EPOLL_CTL_MOD, fd, &event);
+        conn.writing = pending;
+    }
+}
+
+/**
+ * @brief Closes a connection and discards its session
+ * @param fd The socket of the connection
+ */
+void Server::drop(int fd) {
+    epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    this->connections.erase(fd);
+}
+
+/**
+ * @brief Captures a block written by the line being evaluated
+ * @param fd The file descriptor the block must be written to
+ * @param data The content of the block
+ */
+void Server::write(int fd, std::string data) {
+    auto &target = (fd == STDERR_FILENO) ? this->err : this->out;
+    target += data;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
+#include <cstddef>
+
+#include "adt.h"
+#include "register_file.h"
+#include "arena.h"
+#include "output.h"
+
+/**
+ * @brief The state of an interpreter
+ */
+struct Session {
+    dc::Stack<dc::Value> stack;
+    dc::RegisterFile regs;
+    dc::Parameters parameters;
+};
+
+/**
+ * @brief Serves DC sessions over a Unix domain socket
+ *
+ * Each connection has its own session, which starts with an empty stack and with a copy of the registers
+ * and of the parameters of the library(i.e., the macros loaded when the server starts). Copies share
+ * the bodies of the macros, and compiled macros are shared through the macro cache, thus the library is
+ * loaded and compiled only once. Connections are multiplexed by a single thread with epoll, which also
+ * evaluates the lines: a line that does not end(e.g., an infinite macro) blocks every connection.
+ *
+ * Clients send lines of DC code. Each line is evaluated in the session of the connection and is answered
+ * with a header, "<OUTPUT SIZE> <ERROR SIZE>\n", followed by the output and by the errors of the line
+ * (see Client). Reading from the standard input('?') fails, and quitting('q') closes the connection, as does
+ * a line longer than Server::MAX_LINE_SIZE.
+ * The server stops on SIGINT or SIGTERM
+ */
+class Server : public dc::OutputSink {
+public:
+    Server(const std::string &socket_path, const Session &lib, dc::Arena &a);
+    Server(const Server&) = delete;
+    Server &operator=(const Server&) = delete;
+    ~Server() override;
+
+    /**
+     * @brief Returns true if the server is listening on the socket, false otherwise
+     * @return Boolean value
+     */
+    [[nodiscard]] bool is_open() const { return this->listen_fd != -1; }
+    void run();
+    void write(int fd, std::string data) override;
+    void close() override {}
+
+    // Size of the reads from a connection
+    static constexpr std::size_t READ_SIZE = 64 * 1024;
+    // Events taken from epoll at once
+    static constexpr int MAX_EVENTS = 64;
+    // Largest number of bytes a connection can send without a newline
+    static constexpr std::size_t MAX_LINE_SIZE = 1024 * 1024;
+
+private:
+    /**
+     * @brief A client connection and its session
+     */
+    struct Connection {
+        explicit Connection(const Session &lib) : session{{}, lib.regs, lib.parameters} {}
+
+        Session session;
+        std::string input;          // Received bytes not yet evaluated
+        std::string replies;        // Replies not yet sent
+        std::size_t sent = 0;       // Bytes of the replies already sent
+        bool closing = false;       // Whether the connection is closed once the replies are sent
+        bool writing = false;       // Whether the connection waits to be writable
+    };
+
+    void accept_connections();
+    void receive(int fd, Connection &conn);
+    void evaluate(Connection &conn, std::string_view line);
+    void send_replies(int fd, Connection &conn);
+    void drop(int fd);
+
+    std::string path;
+    const Session &library;
+    dc::Arena &arena;
+    dc::Output output;
+    std::string out;
+    std::string err;
+    int listen_fd = -1;
+    int epoll_fd = -1;
+    int signal_fd = -1;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+};
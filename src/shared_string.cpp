@@ -0,0 +1,58 @@
+#include "shared_string.h"
+
+namespace dc {
+    /**
+     * @brief Creates a shared string by copying a string into a new buffer
+     * @param str The content of the shared string
+     *
+     * @return The shared string
+     */
+    SharedString SharedString::copy(std::string_view str) {
+        SharedString res;
+        // Empty strings do not need a buffer
+        if(str.empty()) {
+            return res;
+        }
+
+        auto chars = std::make_shared_for_overwrite<char[]>(str.size());
+        str.copy(chars.get(), str.size());
+        res.data = std::string_view(chars.get(), str.size());
+        res.buffer = std::move(chars);
+
+        return res;
+    }
+
+    /**
+     * @brief Creates a shared string over a string with static storage(e.g., a string literal)
+     *
+     * The characters are neither copied nor owned, thus the string must outlive
+     * every copy of the shared string
+     *
+     * @param literal The content of the shared string
+     *
+     * @return The shared string
+     */
+    SharedString SharedString::from_literal(std::string_view literal) {
+        SharedString res;
+        res.data = literal;
+
+        return res;
+    }
+
+    /**
+     * @brief Creates a view over a part of the string
+     *
+     * The slice shares the buffer of the string, which is kept alive for as long as the slice
+     *
+     * @param sub A substring of this->view()
+     *
+     * @return The slice
+     */
+    SharedString SharedString::slice(std::string_view sub) const {
+        SharedString res;
+        res.buffer = this->buffer;
+        res.data = sub;
+
+        return res;
+    }
+}
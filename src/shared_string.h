@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <memory>
+
+namespace dc {
+    /**
+     * @brief Immutable, reference counted string
+     *
+     * Copies share the same buffer and slices are views over it, thus neither
+     * copying nor slicing a string copies its characters(e.g., a macro pushed onto the
+     * stack, stored into a register or nested into another macro). The buffer is released
+     * when the last string referring to it is destroyed. The characters and the reference
+     * count share a single allocation.
+     */
+    class SharedString {
+    public:
+        SharedString() = default;
+        explicit SharedString(const std::string &str) : SharedString(copy(str)) {}
+        static SharedString copy(std::string_view str);
+        static SharedString from_literal(std::string_view literal);
+
+        [[nodiscard]] std::string_view view() const { return this->data; }
+        [[nodiscard]] bool empty() const { return this->data.empty(); }
+        [[nodiscard]] SharedString slice(std::string_view sub) const;
+
+    private:
+        std::shared_ptr<const char[]> buffer;
+        std::string_view data;
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace dc {
+    /**
+     * @brief Bounded lock-free queue between a single producer thread and a single consumer thread
+     *
+     * Each thread owns one index of the ring buffer and only reads the index of the other one, thus
+     * no lock is needed. A thread that finds the queue full(or empty) sleeps on the index of the other
+     * thread(see std::atomic::wait) until it moves
+     */
+    template<typename T, std::size_t Capacity>
+    class SpscQueue {
+    public:
+        /**
+         * @brief Appends an element, waiting for a free slot if the queue is full
+         * @param value The element to be appended
+         */
+        void push(T value) {
+            auto tail_idx = this->tail.load(std::memory_order_relaxed);
+            auto head_idx = this->head.load(std::memory_order_acquire);
+            while(tail_idx - head_idx == Capacity) {
+                this->head.wait(head_idx, std::memory_order_acquire);
+                head_idx = this->head.load(std::memory_order_acquire);
+            }
+
+            this->slots[tail_idx % Capacity] = std::move(value);
+            this->tail.store(tail_idx + 1, std::memory_order_release);
+            this->tail.notify_one();
+        }
+
+        /**
+         * @brief Removes the oldest element, waiting for one if the queue is empty
+         * @return The element
+         */
+        T pop() {
+            auto head_idx = this->head.load(std::memory_order_relaxed);
+            auto tail_idx = this->tail.load(std::memory_order_acquire);
+            while(tail_idx == head_idx) {
+                this->tail.wait(tail_idx, std::memory_order_acquire);
+                tail_idx = this->tail.load(std::memory_order_acquire);
+            }
+
+            T value = std::move(this->slots[head_idx % Capacity]);
+            this->head.store(head_idx + 1, std::memory_order_release);
+            this->head.notify_one();
+
+            return value;
+        }
+
+    private:
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two");
+
+        std::array<T, Capacity> slots{};
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::atomic<std::size_t> tail{0};
+    };
+}
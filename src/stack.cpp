@@ -1,14 +1,16 @@
-#include <iostream>
 #include <bitset>
 #include <algorithm>
 #include <ranges>
+#include <array>
+#include <charconv>
+#include <cctype>
 
 #include "adt.cpp"
 #include "stack.h"
-#include "num_utils.h"
+#include "output.h"
 
-std::optional<std::string> Stack::exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, __attribute__((unused)) std::unordered_map<char, dc::Register> &regs) {
-    std::optional<std::string> err = std::nullopt;
+std::optional<dc::Error> Stack::exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, __attribute__((unused)) dc::RegisterFile &regs) {
+    std::optional<dc::Error> err = std::nullopt;
     
     auto print_oradix = [&stack, &parameters, this](dc::radix_base base) {
         auto old_rdx = parameters.oradix;
@@ -42,6 +44,7 @@ std::optional<std::string> Stack::exec(dc::Stack<std::string> &stack, dc::Parame
         case OPType::LX: err = fn_get_lastx(stack); break;
         case OPType::LY: err = fn_get_lasty(stack); break;
         case OPType::LZ: err = fn_get_lastz(stack); break;
+        case OPType::FL: dc::Output::instance().flush(); break;
         default: break;
     }
 
@@ -57,45 +60,30 @@ std::optional<std::string> Stack::exec(dc::Stack<std::string> &stack, dc::Parame
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_print(dc::Stack<std::string> &stack, dc::Parameters  &parameters, const StackOP op) {
-    // Check if the stack is empty
-    if(stack.empty()) {
-        return "Cannot print empty stack";
-    }
-
+std::optional<dc::Error> Stack::fn_print(dc::Stack<dc::Value> &stack, dc::Parameters  &parameters, const StackOP op) {
     // If the output radix is non-decimal, check if top of the stack is an integer
-    if(static_cast<int>(parameters.oradix) != 10 && !NumericUtils::is_numeric<int>(stack.pop(false))) {
-        return "This output radix requires integer values";
+    const auto& head = stack.top();
+    if(static_cast<int>(parameters.oradix) != 10 && !head.is_integer()) {
+        return dc::Error(dc::ErrorCode::INTEGER_OUTPUT);
     }
 
+    auto &output = dc::Output::instance();
     switch(parameters.oradix) {
         case dc::radix_base::DEC: {
+            output.write(head.to_string());
             switch(op) {
-                case StackOP::PNL: std::cout << stack.pop(false) << std::endl; break;
-                case StackOP::P: std::cout << stack.pop(false); break;
-                case StackOP::PS: std::cout << stack.pop(false) << ' '; break;
+                case StackOP::PNL: output.put('\n'); break;
+                case StackOP::P: break;
+                case StackOP::PS: output.put(' '); break;
             }
             break;
         }
-        case dc::radix_base::BIN: {
-            std::bitset<64> head{std::stoul(stack.pop(false))};
-            auto bin_value = bin_prettify(head.to_string());
-
-            std::cout << bin_value << std::endl;
-            break;
-        }
-        case dc::radix_base::OCT: {
-            auto head = std::stol(stack.pop(false));
-            std::cout << std::oct << head << 'o' << std::dec << std::endl;
-            break;
-        }
-        case dc::radix_base::HEX: {
-            auto head = std::stol(stack.pop(false));
-            std::cout << std::hex << std::uppercase << head << 'h'
-                      << std::dec << std::nouppercase << std::endl;
+        case dc::radix_base::BIN: case dc::radix_base::OCT: case dc::radix_base::HEX: {
+            output.write(format_radix(head, parameters.oradix));
+            output.put('\n');
             break;
         }
-        default: return "Unsupported output base";
+        default: return dc::Error(dc::ErrorCode::UNSUPPORTED_OUTPUT_BASE);
     }
 
     return std::nullopt;
@@ -110,14 +98,9 @@ std::optional<std::string> Stack::fn_print(dc::Stack<std::string> &stack, dc::Pa
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_pop_head(dc::Stack<std::string> &stack) {
-    // Check if stack is empty
-    if(stack.empty()) {
-        return "'R' does not work on empty stack";
-    }
-
+std::optional<dc::Error> Stack::fn_pop_head(dc::Stack<dc::Value> &stack) {
     stack.copy_xyz();
-    stack.pop(true);
+    stack.drop();
 
     return std::nullopt;
 }
@@ -129,19 +112,12 @@ std::optional<std::string> Stack::fn_pop_head(dc::Stack<std::string> &stack) {
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_swap_xy(dc::Stack<std::string> &stack) {
-    // Check if the stack has enough elements
-    if(stack.size() < 2) {
-        return "'r' requires two elements";
-    }
-
+std::optional<dc::Error> Stack::fn_swap_xy(dc::Stack<dc::Value> &stack) {
     // Swap top two elements
     auto len = stack.size()-1;
-    auto x = stack[len];
-    
+
     stack.copy_xyz();
-    stack[len] = stack[len-1];
-    stack[len-1] = x;
+    stack.swap(len, len-1);
 
     return std::nullopt;
 }
@@ -153,14 +129,8 @@ std::optional<std::string> Stack::fn_swap_xy(dc::Stack<std::string> &stack) {
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_dup_head(dc::Stack<std::string> &stack) {
-    // Check if the stack has enough elements
-    if(stack.empty()) {
-        return "'d' requires one element";
-    }
-
-    auto head = stack.pop(false);
-    stack.push(head);
+std::optional<dc::Error> Stack::fn_dup_head(dc::Stack<dc::Value> &stack) {
+    stack.push(stack.top());
 
     return std::nullopt;
 }
@@ -173,38 +143,13 @@ std::optional<std::string> Stack::fn_dup_head(dc::Stack<std::string> &stack) {
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_print_stack(const dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
+std::optional<dc::Error> Stack::fn_print_stack(const dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     const auto& const_ref = stack.get_ref();
+    auto &output = dc::Output::instance();
 
-    switch(parameters.oradix) {
-        case dc::radix_base::DEC: {
-            for(const auto& it : std::ranges::reverse_view(const_ref)) {
-                std::cout << it << std::endl;
-            }
-            break;
-        }
-        case dc::radix_base::BIN: {
-            for(const auto& it : std::ranges::reverse_view(const_ref)) {
-                std::bitset<64> head{std::stoul(it)};
-                auto bin_value = bin_prettify(head.to_string());
-
-                std::cout << bin_value << std::endl;
-            }
-            break;
-        }
-        case dc::radix_base::OCT: {
-            for(const auto& it : std::ranges::reverse_view(const_ref)) {
-                std::cout << std::oct << std::stol(it) << 'o' << std::dec << std::endl;
-            }
-            break;
-        }
-        case dc::radix_base::HEX: {
-            for(const auto& it : std::ranges::reverse_view(const_ref)) {
-                std::cout << std::hex << std::uppercase << std::stol(it) << 'h'
-                          << std::dec << std::nouppercase << std::endl;
-                }
-            break;
-        }
+    for(const auto& it : std::ranges::reverse_view(const_ref)) {
+        output.write(parameters.oradix == dc::radix_base::DEC ? it.to_string() : format_radix(it, parameters.oradix));
+        output.put('\n');
     }
 
     return std::nullopt;
@@ -221,37 +166,28 @@ std::optional<std::string> Stack::fn_print_stack(const dc::Stack<std::string> &s
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_head_size(dc::Stack<std::string> &stack) {
-    // Check if the stack has enough elements
-    if(stack.empty()) {
-        return "'Z' does not work on empty stack";
-    }
-
+std::optional<dc::Error> Stack::fn_head_size(dc::Stack<dc::Value> &stack) {
     // Take head of the stack
-    auto head = stack.pop(false);
+    const auto& head = stack.top();
+    std::size_t len = 0;
 
     // If it's an integer, count its digits
-    if(NumericUtils::is_numeric<int>(head)) {
-        auto num = std::stoi(head);
-
-        stack.copy_xyz();
-        stack.pop(true);
-
-        std::size_t len = 0;
+    if(head.is_integer()) {
+        auto num = head.to_int();
         while(num > 0) {
             num /= 10;
             len++;
         }
-
-        stack.push(std::to_string(len));
     } else {
         // Otherwise, treat the value as a string and count its length
-        stack.copy_xyz();
-        stack.pop(true);
-        head.erase(std::remove(head.begin(), head.end(), '.'), head.end());
-        stack.push(std::to_string(head.length()));
+        auto str = head.to_string();
+        len = str.length() - std::count(str.begin(), str.end(), '.');
     }
 
+    stack.copy_xyz();
+    stack.drop();
+    stack.push(dc::Value(static_cast<double>(len), 0));
+
     return std::nullopt;
 }
 
@@ -262,8 +198,8 @@ std::optional<std::string> Stack::fn_head_size(dc::Stack<std::string> &stack) {
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_stack_size(dc::Stack<std::string> &stack) {
-    stack.push(std::to_string(stack.size()));
+std::optional<dc::Error> Stack::fn_stack_size(dc::Stack<dc::Value> &stack) {
+    stack.push(dc::Value(static_cast<double>(stack.size()), 0));
 
     return std::nullopt;
 }
@@ -278,23 +214,18 @@ std::optional<std::string> Stack::fn_stack_size(dc::Stack<std::string> &stack) {
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_set_precision(dc::Stack<std::string> &stack, dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'k' requires one operand";
-    }
-
+std::optional<dc::Error> Stack::fn_set_precision(dc::Stack<dc::Value> &stack, dc::Parameters &parameters) {
     // Check whether head is a non-negative number
-    auto head = stack.pop(false);
-    if(!NumericUtils::is_numeric<int>(head) || std::stoi(head) < 0) {
-        return "Precision must be a non-negative number";
+    const auto& head = stack.top();
+    if(!head.is_integer() || head.to_int() < 0) {
+        return dc::Error(dc::ErrorCode::INVALID_PRECISION);
     }
 
     // Otherwise extract head of the stack and use it
     // to set precision parameter
+    parameters.precision = head.to_int();
     stack.copy_xyz();
-    stack.pop(true);
-    parameters.precision = std::stoi(head);
+    stack.drop();
 
     return std::nullopt;
 }
@@ -309,8 +240,8 @@ std::optional<std::string> Stack::fn_set_precision(dc::Stack<std::string> &stack
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_get_precision(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    stack.push(std::to_string(parameters.precision));
+std::optional<dc::Error> Stack::fn_get_precision(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
+    stack.push(dc::Value(static_cast<double>(parameters.precision), 0));
 
     return std::nullopt;
 }
@@ -325,27 +256,22 @@ std::optional<std::string> Stack::fn_get_precision(dc::Stack<std::string> &stack
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_set_oradix(dc::Stack<std::string> &stack, dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'o' requires one operand";
-    }
-
+std::optional<dc::Error> Stack::fn_set_oradix(dc::Stack<dc::Value> &stack, dc::Parameters &parameters) {
     // Check whether the head is a number
     stack.copy_xyz();
     auto head = stack.pop(true);
-    if(!NumericUtils::is_numeric<int>(head)) {
-        return "'o' requires numeric values only";
+    if(!head.is_integer()) {
+        return dc::Error(dc::ErrorCode::NUMERIC_OUTPUT_RADIX);
     }
 
     // Otherwise convert it to int
-    auto oradix = std::stoi(head);
+    auto oradix = head.to_int();
     switch(oradix) {
         case 2: parameters.oradix = dc::radix_base::BIN; break;
         case 8: parameters.oradix = dc::radix_base::OCT; break;
         case 10: parameters.oradix = dc::radix_base::DEC; break;
         case 16: parameters.oradix = dc::radix_base::HEX; break;
-        default: return "'o' accepts either BIN, OCT, DEC or HEX bases";
+        default: return dc::Error(dc::ErrorCode::INVALID_OUTPUT_RADIX);
     }
 
     return std::nullopt;
@@ -361,8 +287,8 @@ std::optional<std::string> Stack::fn_set_oradix(dc::Stack<std::string> &stack, d
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_get_oradix(dc::Stack<std::string> &stack, dc::Parameters &parameters) {
-    stack.push(std::to_string(static_cast<int>(parameters.oradix)));
+std::optional<dc::Error> Stack::fn_get_oradix(dc::Stack<dc::Value> &stack, dc::Parameters &parameters) {
+    stack.push(dc::Value(static_cast<double>(parameters.oradix), 0));
 
     return std::nullopt;
 }
@@ -377,23 +303,18 @@ std::optional<std::string> Stack::fn_get_oradix(dc::Stack<std::string> &stack, d
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_set_iradix(dc::Stack<std::string> &stack, dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.empty()) {
-        return "'i' requires one operand";
-    }
-
+std::optional<dc::Error> Stack::fn_set_iradix(dc::Stack<dc::Value> &stack, dc::Parameters &parameters) {
     // Check whether head is a number within the range 2-16
-    auto head = stack.pop(false);
-    if(!NumericUtils::is_numeric<double>(head) || std::stoi(head) < 2 || std::stoi(head) > 16) {
-        return "Input base must be a number within the range 2-16(inclusive)";
+    const auto& head = stack.top();
+    if(!head.is_number() || head.to_int() < 2 || head.to_int() > 16) {
+        return dc::Error(dc::ErrorCode::INVALID_INPUT_RADIX);
     }
 
     // Otherwise extract head of the stack and use it
     // to set input base
+    parameters.iradix = head.to_int();
     stack.copy_xyz();
-    stack.pop(true);
-    parameters.iradix = std::stoi(head);
+    stack.drop();
 
     return std::nullopt;
 }
@@ -408,8 +329,8 @@ std::optional<std::string> Stack::fn_set_iradix(dc::Stack<std::string> &stack, d
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_get_iradix(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    stack.push(std::to_string(parameters.iradix));
+std::optional<dc::Error> Stack::fn_get_iradix(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
+    stack.push(dc::Value(static_cast<double>(parameters.iradix), 0));
 
     return std::nullopt;
 }
@@ -423,10 +344,10 @@ std::optional<std::string> Stack::fn_get_iradix(dc::Stack<std::string> &stack, c
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_get_lastx(dc::Stack<std::string> &stack) {
+std::optional<dc::Error> Stack::fn_get_lastx(dc::Stack<dc::Value> &stack) {
     // Retrieve last x from the stack and push it back
     auto last_x = stack.get_last_x();
-    last_x.empty() ? stack.push("0") : stack.push(last_x);
+    last_x.empty() ? stack.push(dc::Value(0.0, 0)) : stack.push(std::move(last_x));
 
     return std::nullopt;
 }
@@ -440,10 +361,10 @@ std::optional<std::string> Stack::fn_get_lastx(dc::Stack<std::string> &stack) {
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_get_lasty(dc::Stack<std::string> &stack) {
+std::optional<dc::Error> Stack::fn_get_lasty(dc::Stack<dc::Value> &stack) {
     // Retrieve last y from the stack and push it back
     auto last_y = stack.get_last_y();
-    last_y.empty() ? stack.push("0") : stack.push(last_y);
+    last_y.empty() ? stack.push(dc::Value(0.0, 0)) : stack.push(std::move(last_y));
 
     return std::nullopt;
 }
@@ -457,14 +378,43 @@ std::optional<std::string> Stack::fn_get_lasty(dc::Stack<std::string> &stack) {
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Stack::fn_get_lastz(dc::Stack<std::string> &stack) {
+std::optional<dc::Error> Stack::fn_get_lastz(dc::Stack<dc::Value> &stack) {
     // Retrieve last y from the stack and push it back
     auto last_z = stack.get_last_z();
-    last_z.empty() ? stack.push("0") : stack.push(last_z);
+    last_z.empty() ? stack.push(dc::Value(0.0, 0)) : stack.push(std::move(last_z));
 
     return std::nullopt;
 }
 
+/**
+ * @brief Formats an integer in a non-decimal output radix
+ *
+ * Negative numbers are printed as their two's complement
+ *
+ * @param value The value to be formatted
+ * @param base The output radix(binary, octal or hexadecimal)
+ *
+ * @return The digits of the value followed by the suffix of the radix
+ */
+std::string Stack::format_radix(const dc::Value &value, dc::radix_base base) {
+    if(base == dc::radix_base::BIN) {
+        std::bitset<64> bin_value{value.to_ulong()};
+
+        return bin_prettify(bin_value.to_string());
+    }
+
+    std::array<char, 32> digits{};
+    auto *end = std::to_chars(digits.data(), digits.data() + digits.size(),
+                              static_cast<unsigned long long>(value.to_long()), static_cast<int>(base)).ptr;
+    std::string result(digits.data(), end);
+    if(base == dc::radix_base::HEX) {
+        std::ranges::transform(result, result.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    }
+    result.push_back(base == dc::radix_base::OCT ? 'o' : 'h');
+
+    return result;
+}
+
 /**
  * @brief Pretty prints a binary number
  * 
@@ -22,29 +22,30 @@ public:
      * 
      * @param stack An instance of the dc::Stack data structure
      * @param parameters An instance of the dc::Parameters data structure
-     * @param regs An instance of the dc::Register data structure
+     * @param regs An instance of the dc::RegisterFile data structure
      * 
      * @return Runtime errors, if any
      */
-    std::optional<std::string> exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) override;
+    std::optional<dc::Error> exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) override;
 
 private:
-    std::optional<std::string> fn_print(dc::Stack<std::string> &stack, dc::Parameters  &parameters, const StackOP op);
-    static std::optional<std::string> fn_pop_head(dc::Stack<std::string> &stack);
-    static std::optional<std::string> fn_swap_xy(dc::Stack<std::string> &stack);
-    static std::optional<std::string> fn_dup_head(dc::Stack<std::string> &stack);
-    std::optional<std::string> fn_print_stack(const dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_head_size(dc::Stack<std::string> &stack);
-    static std::optional<std::string> fn_stack_size(dc::Stack<std::string> &stack);
-    static std::optional<std::string> fn_set_precision(dc::Stack<std::string> &stack, dc::Parameters &parameters);
-    static std::optional<std::string> fn_get_precision(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    static std::optional<std::string> fn_set_oradix(dc::Stack<std::string> &stack, dc::Parameters &parameters);
-    static std::optional<std::string> fn_get_oradix(dc::Stack<std::string> &stack, dc::Parameters &parameters);
-    static std::optional<std::string> fn_set_iradix(dc::Stack<std::string> &stack, dc::Parameters &parameters);
-    static std::optional<std::string> fn_get_iradix(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    std::optional<std::string> fn_get_lastx(dc::Stack<std::string> &stack);
-    std::optional<std::string> fn_get_lasty(dc::Stack<std::string> &stack);
-    std::optional<std::string> fn_get_lastz(dc::Stack<std::string> &stack);
+    std::optional<dc::Error> fn_print(dc::Stack<dc::Value> &stack, dc::Parameters  &parameters, const StackOP op);
+    static std::optional<dc::Error> fn_pop_head(dc::Stack<dc::Value> &stack);
+    static std::optional<dc::Error> fn_swap_xy(dc::Stack<dc::Value> &stack);
+    static std::optional<dc::Error> fn_dup_head(dc::Stack<dc::Value> &stack);
+    std::optional<dc::Error> fn_print_stack(const dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_head_size(dc::Stack<dc::Value> &stack);
+    static std::optional<dc::Error> fn_stack_size(dc::Stack<dc::Value> &stack);
+    static std::optional<dc::Error> fn_set_precision(dc::Stack<dc::Value> &stack, dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_get_precision(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_set_oradix(dc::Stack<dc::Value> &stack, dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_get_oradix(dc::Stack<dc::Value> &stack, dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_set_iradix(dc::Stack<dc::Value> &stack, dc::Parameters &parameters);
+    static std::optional<dc::Error> fn_get_iradix(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_get_lastx(dc::Stack<dc::Value> &stack);
+    std::optional<dc::Error> fn_get_lasty(dc::Stack<dc::Value> &stack);
+    std::optional<dc::Error> fn_get_lastz(dc::Stack<dc::Value> &stack);
+    std::string format_radix(const dc::Value &value, dc::radix_base base);
     std::string bin_prettify(std::string s);
 
     OPType op_type;
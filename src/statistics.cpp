@@ -3,10 +3,9 @@
 
 #include "adt.cpp"
 #include "statistics.h"
-#include "num_utils.h"
 
-std::optional<std::string> Statistics::exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
-    std::optional<std::string> err = std::nullopt;
+std::optional<dc::Error> Statistics::exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) {
+    std::optional<dc::Error> err = std::nullopt;
 
     switch(this->op_type) {
         case OPType::PERM: err = fn_perm(stack, parameters); break;
@@ -30,24 +29,19 @@ std::optional<std::string> Statistics::exec(dc::Stack<std::string> &stack, dc::P
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Statistics::fn_perm(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'gP' requires two operands";
-    }
-
+std::optional<dc::Error> Statistics::fn_perm(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto head = stack[len];
-    auto second = stack[len-1];
-    auto is_head_num = NumericUtils::is_numeric<long long>(head);
-    auto is_second_num = NumericUtils::is_numeric<long long>(second);
+    const auto& head = stack[len];
+    const auto& second = stack[len-1];
+    auto is_head_num = head.is_long();
+    auto is_second_num = second.is_long();
 
     // Check whether both entries are integers
     if(is_head_num && is_second_num) {
         stack.copy_xyz();
-        auto x = std::stoll(stack.pop(true));
-        auto y = std::stoll(stack.pop(true));
+        auto x = stack.pop(true).to_long();
+        auto y = stack.pop(true).to_long();
 
         // Define a factorial lambda function
         auto factorial = [](long long int val) -> std::optional<unsigned long long int> {
@@ -69,13 +63,13 @@ std::optional<std::string> Statistics::fn_perm(dc::Stack<std::string> &stack, co
         auto numerator_opt = factorial(y);
         auto denominator_opt = factorial(y - x);
         if(numerator_opt == std::nullopt || denominator_opt == std::nullopt) {
-            return "'gP' requires positive integers";
+            return dc::Error(dc::ErrorCode::POSITIVE_INTEGERS, "gP");
         }
 
         unsigned long long permutation = numerator_opt.value() / denominator_opt.value();
-        stack.push(NumericUtils::format_number(static_cast<double>(permutation), parameters.precision));
+        stack.push(dc::Value(static_cast<double>(permutation), parameters.precision));
     } else {
-        return "'gP' requires integer values";
+        return dc::Error(dc::ErrorCode::INTEGER_OPERANDS, "gP");
     }
 
     return std::nullopt;
@@ -89,28 +83,23 @@ std::optional<std::string> Statistics::fn_perm(dc::Stack<std::string> &stack, co
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Statistics::fn_comb(dc::Stack<std::string> &stack, const dc::Parameters &parameters) {
-    // Check if stack has enough elements
-    if(stack.size() < 2) {
-        return "'gC' requires two operands";
-    }
-
+std::optional<dc::Error> Statistics::fn_comb(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters) {
     // Extract two entries from the stack
     auto len = stack.size()-1;
-    auto head = stack[len];
-    auto second = stack[len-1];
-    auto is_head_num = NumericUtils::is_numeric<long long>(head);
-    auto is_second_num = NumericUtils::is_numeric<long long>(second);
+    const auto& head = stack[len];
+    const auto& second = stack[len-1];
+    auto is_head_num = head.is_long();
+    auto is_second_num = second.is_long();
 
     // Check whether both entries are integers
     if(is_head_num && is_second_num) {
         stack.copy_xyz();
-        auto n = std::stoull(stack.pop(true));
-        auto k = std::stoull(stack.pop(true));
+        auto n = stack.pop(true).to_ulong();
+        auto k = stack.pop(true).to_ulong();
 
         // Check if combination is non-negative
         if(n > k) {
-            return "'gC' requires positive integers";
+            return dc::Error(dc::ErrorCode::POSITIVE_INTEGERS, "gC");
         }
 
         // From Knuth's "Seminumerical Algorithms" book
@@ -120,9 +109,9 @@ std::optional<std::string> Statistics::fn_comb(dc::Stack<std::string> &stack, co
             combination /= i;
         }
 
-        stack.push(NumericUtils::format_number(static_cast<double>(combination), parameters.precision));
+        stack.push(dc::Value(static_cast<double>(combination), parameters.precision));
     } else {
-        return "'gC' requires integer values";
+        return dc::Error(dc::ErrorCode::INTEGER_OPERANDS, "gC");
     }
 
     return std::nullopt;
@@ -133,24 +122,25 @@ std::optional<std::string> Statistics::fn_comb(dc::Stack<std::string> &stack, co
  * 
  * @param stack An instance of the dc::Stack data structure
  * @param parameters An instance of the dc::Parameters data structure
- * @param regs An instance of the dc::Register data structure
+ * @param regs An instance of the dc::RegisterFile data structure
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Statistics::fn_sum(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
+std::optional<dc::Error> Statistics::fn_sum(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs) {
     // Check whether 'x' register exists
-    if(regs.find('X') == regs.end()) {
-        return "Register 'X' is undefined";
+    auto *x_reg = regs.find('X');
+    if(x_reg == nullptr) {
+        return dc::Error(dc::ErrorCode::UNDEFINED_REGISTER, 'X');
     }
 
     // Check if register's stack is empty
-    if(regs['X'].stack.empty()) {
-        return "The stack of register 'X' is empty";
+    if(x_reg->stack.empty()) {
+        return dc::Error(dc::ErrorCode::EMPTY_REGISTER, 'X');
     }
 
     // Otherwise retrieve summation of register's stack
-    auto summation = regs['X'].stack.summation();
-    stack.push(NumericUtils::format_number(summation, parameters.precision));
+    auto summation = x_reg->stack.summation();
+    stack.push(dc::Value(summation, parameters.precision));
 
     return std::nullopt;
 }
@@ -160,24 +150,25 @@ std::optional<std::string> Statistics::fn_sum(dc::Stack<std::string> &stack, con
  * 
  * @param stack An instance of the dc::Stack data structure
  * @param parameters An instance of the dc::Parameters data structure
- * @param regs An instance of the dc::Register data structure
+ * @param regs An instance of the dc::RegisterFile data structure
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Statistics::fn_sum_squared(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
+std::optional<dc::Error> Statistics::fn_sum_squared(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs) {
     // Check whether 'x' register exists
-    if(regs.find('X') == regs.end()) {
-        return "Register 'X' is undefined";
+    auto *x_reg = regs.find('X');
+    if(x_reg == nullptr) {
+        return dc::Error(dc::ErrorCode::UNDEFINED_REGISTER, 'X');
     }
 
     // Check if register's stack is empty
-    if(regs['X'].stack.empty()) {
-        return "The stack of register 'X' is empty";
+    if(x_reg->stack.empty()) {
+        return dc::Error(dc::ErrorCode::EMPTY_REGISTER, 'X');
     }
 
     // Otherwise retrieve summation of squares of register's stack
-    auto summation_squared = regs['X'].stack.summation_squared();
-    stack.push(NumericUtils::format_number(summation_squared, parameters.precision));
+    auto summation_squared = x_reg->stack.summation_squared();
+    stack.push(dc::Value(summation_squared, parameters.precision));
 
     return std::nullopt;
 }
@@ -187,26 +178,27 @@ std::optional<std::string> Statistics::fn_sum_squared(dc::Stack<std::string> &st
  * 
  * @param stack An instance of the dc::Stack data structure
  * @param parameters An instance of the dc::Parameters data structure
- * @param regs An instance of the dc::Register data structure
+ * @param regs An instance of the dc::RegisterFile data structure
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Statistics::fn_mean(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
+std::optional<dc::Error> Statistics::fn_mean(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs) {
     // Check whether 'x' register exists
-    if(regs.find('X') == regs.end()) {
-        return "Register 'X' is undefined";
+    auto *x_reg = regs.find('X');
+    if(x_reg == nullptr) {
+        return dc::Error(dc::ErrorCode::UNDEFINED_REGISTER, 'X');
     }
 
     // Check if register's stack is empty
-    if(regs['X'].stack.empty()) {
-        return "The stack of register 'X' is empty";
+    if(x_reg->stack.empty()) {
+        return dc::Error(dc::ErrorCode::EMPTY_REGISTER, 'X');
     }
 
     // Otherwise compute mean
-    auto summation = regs['X'].stack.summation();
-    auto size = regs['X'].stack.size();
+    auto summation = x_reg->stack.summation();
+    auto size = x_reg->stack.size();
     auto mean = summation / static_cast<double>(size);
-    stack.push(NumericUtils::format_number(mean, parameters.precision));
+    stack.push(dc::Value(mean, parameters.precision));
 
     return std::nullopt;
 }
@@ -216,31 +208,32 @@ std::optional<std::string> Statistics::fn_mean(dc::Stack<std::string> &stack, co
  * 
  * @param stack An instance of the dc::Stack data structure
  * @param parameters An instance of the dc::Parameters data structure
- * @param regs An instance of the dc::Register data structure
+ * @param regs An instance of the dc::RegisterFile data structure
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Statistics::fn_sdev(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
+std::optional<dc::Error> Statistics::fn_sdev(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs) {
     // Check whether 'x' register exists
-    if(regs.find('X') == regs.end()) {
-        return "Register 'X' is undefined";
+    auto *x_reg = regs.find('X');
+    if(x_reg == nullptr) {
+        return dc::Error(dc::ErrorCode::UNDEFINED_REGISTER, 'X');
     }
 
     // Check if register's stack is empty
-    if(regs['X'].stack.empty()) {
-        return "The stack of register 'X' is empty";
+    if(x_reg->stack.empty()) {
+        return dc::Error(dc::ErrorCode::EMPTY_REGISTER, 'X');
     }
 
     // Otherwise, compute the mean
-    auto summation = regs['X'].stack.summation();
-    auto count = regs['X'].stack.size();
+    auto summation = x_reg->stack.summation();
+    auto count = x_reg->stack.size();
     auto mean = summation / static_cast<double>(count);
 
     // Then compute the sum of the deviations from the mean and square the result
-    const auto& const_vec = regs['X'].stack.get_ref();
+    const auto& const_vec = x_reg->stack.get_ref();
     double sum_of_deviations = std::accumulate(const_vec.begin(), const_vec.end(), 0.0, 
-        [&](double acc, const std::string& val) {
-            double deviation = std::stod(val) - mean;
+        [&](double acc, const dc::Value& val) {
+            double deviation = val.to_double() - mean;
             return acc + std::pow(deviation, 2);
     });
     // Then compute the mean of previous values(variance)
@@ -249,7 +242,7 @@ std::optional<std::string> Statistics::fn_sdev(dc::Stack<std::string> &stack, co
     // Finally, compute the square root of the variance(standard deviation)
     auto s_dev = sqrt(variance);
 
-    stack.push(NumericUtils::format_number(s_dev, parameters.precision));
+    stack.push(dc::Value(s_dev, parameters.precision));
     return std::nullopt;
 }
 
@@ -259,55 +252,57 @@ std::optional<std::string> Statistics::fn_sdev(dc::Stack<std::string> &stack, co
  * 
  * @param stack An instance of the dc::Stack data structure
  * @param parameters An instance of the dc::Parameters data structure
- * @param regs An instance of the dc::Register data structure
+ * @param regs An instance of the dc::RegisterFile data structure
  * 
  * @return Evaluation errors, if any
  */
-std::optional<std::string> Statistics::fn_lreg(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) {
+std::optional<dc::Error> Statistics::fn_lreg(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs) {
      // Check whether 'x' register exists
-    if(regs.find('X') == regs.end()) {
-        return "Register 'X' is undefined";
+    auto *x_reg = regs.find('X');
+    if(x_reg == nullptr) {
+        return dc::Error(dc::ErrorCode::UNDEFINED_REGISTER, 'X');
     }
 
     // Check if register's stack is empty
-    if(regs['X'].stack.empty()) {
-        return "The stack of register 'X' is empty";
+    if(x_reg->stack.empty()) {
+        return dc::Error(dc::ErrorCode::EMPTY_REGISTER, 'X');
     }
 
      // Check whether 'y' register exists
-    if(regs.find('Y') == regs.end()) {
-        return "Register 'Y' is undefined";
+    auto *y_reg = regs.find('Y');
+    if(y_reg == nullptr) {
+        return dc::Error(dc::ErrorCode::UNDEFINED_REGISTER, 'Y');
     }
 
     // Check if register's stack is empty
-    if(regs['Y'].stack.empty()) {
-        return "The stack of register 'Y' is empty";
+    if(y_reg->stack.empty()) {
+        return dc::Error(dc::ErrorCode::EMPTY_REGISTER, 'Y');
     }
 
     // Check that both registers have the same length
-    if(regs['X'].stack.size() != regs['Y'].stack.size()) {
-        return "'X' and 'Y' registers must be of the same length";
+    if(x_reg->stack.size() != y_reg->stack.size()) {
+        return dc::Error(dc::ErrorCode::REGISTER_LENGTH_MISMATCH);
     }
 
     // Otherwise, retrieve count and summations of both sets
-    auto count = regs['X'].stack.size();
-    auto x_sum = regs['X'].stack.summation();
-    auto y_sum = regs['Y'].stack.summation();
+    auto count = x_reg->stack.size();
+    auto x_sum = x_reg->stack.summation();
+    auto y_sum = y_reg->stack.summation();
 
     // Then compute the sum of products
-    const auto& x_ref = regs['X'].stack.get_ref();
-    const auto& y_ref = regs['Y'].stack.get_ref();
+    const auto& x_ref = x_reg->stack.get_ref();
+    const auto& y_ref = y_reg->stack.get_ref();
     std::size_t idx = 0;
     double sum_of_products = 0.0;
 
     for(const auto& it : x_ref) {
-        auto x = std::stod(it);
-        auto y = std::stod(y_ref[idx++]);
+        auto x = it.to_double();
+        auto y = y_ref[idx++].to_double();
         sum_of_products += (x * y);
     }
 
     // Then compute the sum of squares
-    auto x_sum_squares = regs['X'].stack.summation_squared();
+    auto x_sum_squares = x_reg->stack.summation_squared();
 
     // Then compute the slope of the line(m)
     auto slope_numerator = ((static_cast<double>(count) * sum_of_products) - (x_sum * y_sum));
@@ -318,8 +313,8 @@ std::optional<std::string> Statistics::fn_lreg(dc::Stack<std::string> &stack, co
     auto intercept = (y_sum - (slope * x_sum)) / static_cast<double>(count);
 
     // Finally push the slope and the intercept(in this order) into the main stack
-    stack.push(NumericUtils::format_number(slope, parameters.precision));
-    stack.push(NumericUtils::format_number(intercept, parameters.precision));
+    stack.push(dc::Value(slope, parameters.precision));
+    stack.push(dc::Value(intercept, parameters.precision));
 
     return std::nullopt;
 }
\ No newline at end of file
@@ -18,20 +18,20 @@ public:
      * 
      * @param stack An instance of the dc::Stack data structure
      * @param parameters An instance of the dc::Parameters data structure
-     * @param regs An instance of the dc::Register data structure
+     * @param regs An instance of the dc::RegisterFile data structure
      * 
      * @return Runtime errors, if any
      */
-    std::optional<std::string> exec(dc::Stack<std::string> &stack, dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs) override;
+    std::optional<dc::Error> exec(dc::Stack<dc::Value> &stack, dc::Parameters &parameters, dc::RegisterFile &regs) override;
 
 private:
-    std::optional<std::string> fn_perm(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    std::optional<std::string> fn_comb(dc::Stack<std::string> &stack, const dc::Parameters &parameters);
-    std::optional<std::string> fn_sum(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
-    std::optional<std::string> fn_sum_squared(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
-    std::optional<std::string> fn_mean(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
-    std::optional<std::string> fn_sdev(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
-    std::optional<std::string> fn_lreg(dc::Stack<std::string> &stack, const dc::Parameters &parameters, std::unordered_map<char, dc::Register> &regs);
+    std::optional<dc::Error> fn_perm(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_comb(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters);
+    std::optional<dc::Error> fn_sum(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs);
+    std::optional<dc::Error> fn_sum_squared(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs);
+    std::optional<dc::Error> fn_mean(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs);
+    std::optional<dc::Error> fn_sdev(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs);
+    std::optional<dc::Error> fn_lreg(dc::Stack<dc::Value> &stack, const dc::Parameters &parameters, dc::RegisterFile &regs);
 
     OPType op_type;
 };
@@ -0,0 +1,122 @@
+#include <algorithm>
+
+#include "thread_pool.h"
+
+namespace dc {
+    /**
+     * @brief Starts the workers of the pool
+     * @param workers The number of worker threads, at least one
+     */
+    ThreadPool::ThreadPool(std::size_t workers) {
+        workers = std::max<std::size_t>(workers, 1);
+        for(std::size_t idx = 0; idx < workers; idx++) {
+            this->queues.push_back(std::make_unique<Queue>());
+        }
+        for(std::size_t idx = 0; idx < workers; idx++) {
+            this->threads.emplace_back(&ThreadPool::work, this, idx);
+        }
+    }
+
+    /**
+     * @brief Executes the remaining tasks and stops the workers
+     */
+    ThreadPool::~ThreadPool() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            this->stopping = true;
+        }
+        this->ready.notify_all();
+
+        for(auto &thread : this->threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Deals a task to the next worker
+     *
+     * Tasks must be submitted by a single thread
+     *
+     * @param task The task to be executed
+     */
+    void ThreadPool::submit(Task task) {
+        auto &queue = *this->queues[this->next];
+        this->next = (this->next + 1) % this->queues.size();
+
+        this->pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(queue.mtx);
+            queue.tasks.push_back(std::move(task));
+            this->queued.fetch_add(1, std::memory_order_release);
+        }
+
+        // Taking the lock orders the new task before the check of a worker going to sleep
+        { std::lock_guard<std::mutex> lock(this->mtx); }
+        this->ready.notify_one();
+    }
+
+    /**
+     * @brief Waits until every submitted task has been executed
+     */
+    void ThreadPool::wait() {
+        std::unique_lock<std::mutex> lock(this->mtx);
+        this->idle.wait(lock, [this] { return this->pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    /**
+     * @brief Body of a worker thread
+     * @param worker The index of the worker
+     */
+    void ThreadPool::work(std::size_t worker) {
+        while(true) {
+            Task task;
+            if(take(worker, task)) {
+                task(worker);
+                if(this->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    { std::lock_guard<std::mutex> lock(this->mtx); }
+                    this->idle.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(this->mtx);
+            this->ready.wait(lock, [this] {
+                return this->stopping || this->queued.load(std::memory_order_acquire) != 0;
+            });
+            if(this->stopping && this->queued.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Takes a task from the front of the deque of the worker or, if it is empty, steals one
+     * from the back of the deque of another worker
+     * @param worker The index of the worker
+     * @param task The task taken
+     * @return false if every deque is empty, true otherwise
+     */
+    bool ThreadPool::take(std::size_t worker, Task &task) {
+        for(std::size_t offset = 0; offset < this->queues.size(); offset++) {
+            auto &queue = *this->queues[(worker + offset) % this->queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mtx);
+            if(queue.tasks.empty()) {
+                continue;
+            }
+
+            if(offset == 0) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            } else {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            this->queued.fetch_sub(1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+
+namespace dc {
+    /**
+     * @brief Fixed set of worker threads executing tasks with work stealing
+     *
+     * Each worker owns a deque of tasks: it takes its own tasks from the front and, once its deque is empty,
+     * steals the tasks of the other workers from the back, so that a worker that is given slower tasks
+     * does not hold back the others. Tasks are dealt to the workers in turn by a single submitting thread,
+     * which can then wait for all of them to be executed. Idle workers sleep until a task is submitted
+     */
+    class ThreadPool {
+    public:
+        // A task is told the index of the worker executing it
+        using Task = std::function<void(std::size_t worker)>;
+
+        explicit ThreadPool(std::size_t workers);
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool &operator=(const ThreadPool&) = delete;
+        ~ThreadPool();
+        void submit(Task task);
+        void wait();
+
+        /**
+         * @brief Returns the number of workers of the pool
+         * @return The number of workers
+         */
+        [[nodiscard]] std::size_t size() const { return this->threads.size(); }
+
+    private:
+        /**
+         * @brief The deque of a worker, on its own cache line
+         */
+        struct alignas(64) Queue {
+            std::mutex mtx;
+            std::deque<Task> tasks;
+        };
+
+        void work(std::size_t worker);
+        bool take(std::size_t worker, Task &task);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> queued{0};     // Tasks waiting in the deques
+        std::atomic<std::size_t> pending{0};    // Tasks submitted and not yet executed
+        std::size_t next = 0;                   // The worker the next task is dealt to
+        bool stopping = false;
+        std::mutex mtx;
+        std::condition_variable ready;
+        std::condition_variable idle;
+    };
+}
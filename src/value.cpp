@@ -0,0 +1,366 @@
+#include <charconv>
+#include <climits>
+
+#include "value.h"
+#include "num_utils.h"
+
+#define WHITESPACES " \t\n\v\f\r"
+
+/**
+ * @brief Rounds a number to the digits that NumericUtils::format_number would print
+ *
+ * @param number The number to be rounded
+ * @param precision The precision to round the number to. It is updated with
+ * the number of decimal digits that have been actually used
+ *
+ * @return The rounded number
+ */
+static double round_number(double number, unsigned int &precision) {
+    // Integers are not affected by rounding
+    if(std::fmod(number, 1.0) == 0.0) {
+        return number;
+    }
+
+    // Preserve non-zero decimals even when precision is zero
+    if(precision == 0) {
+        precision = 2;
+    }
+
+    char buf[NumericUtils::FORMAT_BUFFER_SIZE];
+    auto end = NumericUtils::format_number(number, precision, buf, buf + sizeof(buf));
+    if(end == nullptr) {
+        // Do not truncate huge precisions
+        return std::strtod(NumericUtils::format_number(number, precision).c_str(), nullptr);
+    }
+
+    double rounded = number;
+    std::from_chars(buf, end, rounded);
+
+    return rounded;
+}
+
+/**
+ * @brief Reads the next non-whitespace character of a string
+ *
+ * @param str The string to be read. On success, the character is removed from it
+ * @param c The character that has been read
+ *
+ * @return false if there are no characters left, true otherwise
+ */
+static bool next_char(std::string_view &str, char &c) {
+    auto pos = str.find_first_not_of(WHITESPACES);
+    if(pos == std::string_view::npos) {
+        return false;
+    }
+
+    c = str[pos];
+    str.remove_prefix(pos + 1);
+
+    return true;
+}
+
+/**
+ * @brief Returns true if **str** is a complex number of the form "(Re,Im)", false otherwise
+ *
+ * The real and the imaginary part can be separated by any character, as long as
+ * both of them are numbers and nothing follows the imaginary part
+ *
+ * @param str A string containing a number
+ *
+ * @return boolean value
+ */
+static bool is_complex_str(std::string_view str) {
+    if(str.empty() || str.front() != '(' || str.back() != ')') {
+        return false;
+    }
+
+    // Extract "Re,Im" without parenthesis
+    auto inner = str.substr(1, str.size() - 2);
+    if(!NumericUtils::extract_number(inner)) {
+        return false;
+    }
+
+    // Skip the separator
+    char separator = 0;
+    if(!next_char(inner, separator)) {
+        return false;
+    }
+
+    return NumericUtils::extract_number(inner) && inner.empty();
+}
+
+/**
+ * @brief Parses a complex number on a best effort basis
+ *
+ * Accepts "(Re,Im)", "(Re)" and "Re" like reading a std::complex from a stream.
+ * Malformed strings are parsed as zero
+ *
+ * @param str The string to be parsed
+ *
+ * @return The parsed complex number
+ */
+static std::complex<double> parse_complex(std::string_view str) {
+    auto pos = str.find_first_not_of(WHITESPACES);
+    if(pos == std::string_view::npos) {
+        return {};
+    }
+
+    // A number without parenthesis is a real number
+    if(str[pos] != '(') {
+        auto real = NumericUtils::extract_number(str);
+
+        return real ? std::complex<double>(*real, 0.0) : std::complex<double>{};
+    }
+    str.remove_prefix(pos + 1);
+
+    char c = 0;
+    auto real = NumericUtils::extract_number(str);
+    if(!real || !next_char(str, c)) {
+        return {};
+    }
+
+    if(c == ')') {
+        return {*real, 0.0};
+    }
+
+    if(c != ',') {
+        return {};
+    }
+
+    auto imag = NumericUtils::extract_number(str);
+    if(!imag || !next_char(str, c) || c != ')') {
+        return {};
+    }
+
+    return {*real, *imag};
+}
+
+namespace dc {
+    /**
+     * @brief Creates a value from its textual representation
+     *
+     * The string is classified by its content: it becomes a number or a complex number
+     * if it can be parsed as such, otherwise it is kept as a string
+     *
+     * @param str The textual representation of the value
+     */
+    Value::Value(const std::string &str) : Value(SharedString(str)) {}
+
+    /**
+     * @brief Overload of Value constructor for shared strings
+     *
+     * The value shares the text with **str**
+     *
+     * @param str The textual representation of the value
+     */
+    Value::Value(SharedString str) : text(std::move(str)) {
+        auto view = this->text.view();
+
+        // Integers are parsed once, without going through the floating point parser
+        if(auto integer = NumericUtils::parse_number<long long>(view)) {
+            this->type = Kind::NUMBER;
+            // Keep the sign of negative zero, which affects complex results
+            this->val = std::copysign(static_cast<double>(*integer), view.find('-') != std::string_view::npos ? -1.0 : 1.0);
+            this->long_fit = true;
+            this->int_fit = *integer >= INT_MIN && *integer <= INT_MAX;
+        } else if(auto number = NumericUtils::parse_number<double>(view)) {
+            this->type = Kind::NUMBER;
+            this->val = *number;
+        } else if(is_complex_str(view)) {
+            this->type = Kind::COMPLEX;
+            this->val = parse_complex(view);
+        }
+    }
+
+    /**
+     * @brief Creates a value from the result of a numeric operation
+     *
+     * The number is rounded according to the precision. Infinities and NaNs
+     * are not valid DC numbers, thus they are stored as strings
+     *
+     * @param number The result of the operation
+     * @param precision The precision of the operation
+     */
+    Value::Value(double number, unsigned int precision) {
+        if(!std::isfinite(number)) {
+            this->text = SharedString(NumericUtils::format_number(number, precision));
+            return;
+        }
+
+        this->type = Kind::NUMBER;
+        this->val = round_number(number, precision);
+        this->re_digits = precision;
+        set_integer_flags();
+    }
+
+    /**
+     * @brief Overload of Value constructor for complex numbers
+     *
+     * Both the real and the imaginary part are rounded according to the precision
+     *
+     * @param number The result of the operation
+     * @param precision The precision of the operation
+     */
+    Value::Value(std::complex<double> number, unsigned int precision) {
+        if(!std::isfinite(number.real()) || !std::isfinite(number.imag())) {
+            this->text = SharedString('(' + NumericUtils::format_number(number.real(), precision) + ','
+                                    + NumericUtils::format_number(number.imag(), precision) + ')');
+            return;
+        }
+
+        this->type = Kind::COMPLEX;
+        this->re_digits = precision;
+        this->im_digits = precision;
+        this->val = std::complex<double>(round_number(number.real(), this->re_digits),
+                                         round_number(number.imag(), this->im_digits));
+    }
+
+    /**
+     * @brief Computes whether the value fits into integral types
+     *
+     * A rounded number is an integer only if it has no decimal digits
+     */
+    void Value::set_integer_flags() {
+        if(this->re_digits != 0) {
+            return;
+        }
+
+        auto number = this->val.real();
+        this->int_fit = (number >= static_cast<double>(INT_MIN) && number <= static_cast<double>(INT_MAX));
+        this->long_fit = (number >= -0x1p63 && number < 0x1p63);
+    }
+
+    /**
+     * @brief Returns true if the value is an empty string, false otherwise
+     * @return Boolean value
+     */
+    bool Value::empty() const {
+        return this->type == Kind::STRING && this->text.empty();
+    }
+
+    /**
+     * @brief Converts the value to a double
+     *
+     * Non-numeric values are converted by parsing their textual representation
+     *
+     * @return The value as a double
+     */
+    double Value::to_double() const {
+        if(this->type == Kind::NUMBER) {
+            return this->val.real();
+        }
+
+        return std::stod(to_string());
+    }
+
+    /**
+     * @brief Converts the value to an integer
+     *
+     * Values that are not integers are converted by parsing their textual representation
+     *
+     * @return The value as an integer
+     */
+    int Value::to_int() const {
+        if(this->int_fit) {
+            return static_cast<int>(this->val.real());
+        }
+
+        return std::stoi(to_string());
+    }
+
+    /**
+     * @brief Converts the value to a long integer
+     *
+     * Values that are not integers(or that are too big to be exactly represented
+     * by a double) are converted by parsing their textual representation
+     *
+     * @return The value as a long integer
+     */
+    long long Value::to_long() const {
+        if(this->long_fit && std::abs(this->val.real()) <= 0x1p53) {
+            return static_cast<long long>(this->val.real());
+        }
+
+        return std::stol(to_string());
+    }
+
+    /**
+     * @brief Converts the value to an unsigned long integer
+     *
+     * Negative numbers wrap around, like the standard library does
+     *
+     * @return The value as an unsigned long integer
+     */
+    unsigned long long Value::to_ulong() const {
+        if(this->long_fit && std::abs(this->val.real()) <= 0x1p53) {
+            return static_cast<unsigned long long>(static_cast<long long>(this->val.real()));
+        }
+
+        return std::stoul(to_string());
+    }
+
+    /**
+     * @brief Converts the value to a complex number
+     *
+     * Real numbers have a null imaginary part, while strings
+     * are parsed on a best effort basis
+     *
+     * @return The value as a complex number
+     */
+    std::complex<double> Value::to_complex() const {
+        switch(this->type) {
+            case Kind::NUMBER: return {this->val.real(), 0.0};
+            case Kind::COMPLEX: return this->val;
+            case Kind::STRING: break;
+        }
+
+        return parse_complex(this->text.view());
+    }
+
+    /**
+     * @brief Gets the textual representation of the value
+     * @return The value as a string
+     */
+    std::string Value::to_string() const {
+        if(this->type == Kind::STRING || !this->text.empty()) {
+            return std::string(this->text.view());
+        }
+
+        if(this->type == Kind::NUMBER) {
+            return NumericUtils::format_number(this->val.real(), this->re_digits);
+        }
+
+        // Format both parts into the same buffer, if they fit
+        char buf[2 * NumericUtils::FORMAT_BUFFER_SIZE];
+        char *last = buf + sizeof(buf);
+        char *end = buf;
+        *end++ = '(';
+        end = NumericUtils::format_number(this->val.real(), this->re_digits, end, last - 1);
+        if(end != nullptr) {
+            *end++ = ',';
+            end = NumericUtils::format_number(this->val.imag(), this->im_digits, end, last - 1);
+        }
+        if(end != nullptr) {
+            *end++ = ')';
+            return std::string(buf, end);
+        }
+
+        return '(' + NumericUtils::format_number(this->val.real(), this->re_digits) + ','
+             + NumericUtils::format_number(this->val.imag(), this->im_digits) + ')';
+    }
+
+    /**
+     * @brief Gets the textual representation of the value as a shared string
+     *
+     * Unlike Value::to_string, strings are not copied
+     *
+     * @return The value as a shared string
+     */
+    SharedString Value::to_shared_string() const {
+        if(this->type == Kind::STRING || !this->text.empty()) {
+            return this->text;
+        }
+
+        return SharedString(to_string());
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <complex>
+#include <cstdint>
+
+#include "shared_string.h"
+
+namespace dc {
+    /**
+     * @brief Value data type
+     *
+     * A tagged value that can either be a real number, a complex number or a string(e.g., a macro).
+     * Values produced by a numeric operation are stored in binary form, along with the number
+     * of decimal digits they have been rounded to. Their textual representation is only computed when
+     * needed(e.g., when printing). Values created from a string(e.g., literals) keep their original text,
+     * so that they are printed exactly as they have been entered. The text is a dc::SharedString, thus
+     * copying a value never copies its text.
+     */
+    class Value {
+    public:
+        enum class Kind : std::uint8_t { NUMBER, COMPLEX, STRING };
+
+        Value() = default;
+        explicit Value(const std::string &str);
+        explicit Value(SharedString str);
+        Value(double number, unsigned int precision);
+        Value(std::complex<double> number, unsigned int precision);
+
+        [[nodiscard]] Kind kind() const { return this->type; }
+        [[nodiscard]] bool is_number() const { return this->type == Kind::NUMBER; }
+        [[nodiscard]] bool is_complex() const { return this->type == Kind::COMPLEX; }
+        [[nodiscard]] bool is_integer() const { return this->int_fit; }
+        [[nodiscard]] bool is_long() const { return this->long_fit; }
+        [[nodiscard]] bool empty() const;
+        [[nodiscard]] double to_double() const;
+        [[nodiscard]] int to_int() const;
+        [[nodiscard]] long long to_long() const;
+        [[nodiscard]] unsigned long long to_ulong() const;
+        [[nodiscard]] std::complex<double> to_complex() const;
+        [[nodiscard]] std::string to_string() const;
+        [[nodiscard]] SharedString to_shared_string() const;
+
+    private:
+        void set_integer_flags();
+
+        SharedString text;
+        std::complex<double> val{};
+        unsigned int re_digits = 0;
+        unsigned int im_digits = 0;
+        Kind type = Kind::STRING;
+        bool int_fit = false;
+        bool long_fit = false;
+    };
+}
@@ -0,0 +1,57 @@
+#!/bin/sh -e
+# μBench: benchmarking companion of μTest written in POSIX sh
+# Each benchmark file defines a 'ubench' function which times the
+# program through the 'measure' helper. Run the same benchmarks
+# against two builds to compare them.
+#
+
+### Helper functions ###
+now_ns() {
+    date +%s%N
+}
+
+# Generates a file with the given dc snippet repeated N times
+# Usage: repeat <FILE> <N> <SNIPPET>
+repeat() {
+    awk -v n="$2" -v s="$3" 'BEGIN { for(i = 0; i < n; i++) print s }' > "$1"
+}
+
+# Runs a command and prints its wall clock time. If the number of
+# operations is specified, prints the time per operation as well
+# Usage: measure <LABEL> <OPS> <COMMAND...>
+measure() {
+    LABEL="$1"
+    OPS="$2"
+    shift 2
+
+    START=$(now_ns)
+    "$@" > /dev/null
+    END=$(now_ns)
+    ELAPSED=$((END - START))
+
+    if [ "$OPS" -gt 0 ]; then
+        printf "  %-40s %10s ms %10s ns/op\n" "$LABEL" "$((ELAPSED / 1000000))" "$((ELAPSED / OPS))"
+    else
+        printf "  %-40s %10s ms\n" "$LABEL" "$((ELAPSED / 1000000))"
+    fi
+}
+######
+
+# Check whether benchmarks directory is specified and exists
+[ "$#" -lt 1 ] && { echo "Usage: $0 <BENCH_DIR> [PROGRAM]"; exit 1; } || BENCH_DIR="$1"
+[ ! -d "$BENCH_DIR" ] && { echo "'$BENCH_DIR' directory not found"; exit 1; }
+PROGRAM="${2:-$PWD/build/dc}"
+[ ! -x "$PROGRAM" ] && { echo "'$PROGRAM' is not executable"; exit 1; }
+BENCH_TMP=$(mktemp -d)
+trap 'rm -rf "$BENCH_TMP"' EXIT
+
+printf "Benchmarking '%s'\n" "$PROGRAM"
+for bench_file in $(printf "%s\n" "$BENCH_DIR"/bench_* | sort); do
+    if [ -f "$bench_file" ]; then
+        printf "Running '%s'...\n" "$bench_file"
+        # shellcheck source=benchmarks/bench_dispatch
+        . "$bench_file"
+        ubench
+    fi
+done
+# vim: ts=4 sw=4 softtabstop=4 expandtab: